@@ -21,20 +21,27 @@
 #include <FreeRTOS.h>
 #include <Seeed_Arduino_SSCMA.h>
 #include <Wire.h>
+#include <esp_heap_caps.h>
 #include <esp_http_server.h>
+#include <esp_idf_version.h>
 #include <esp_timer.h>
 #include <freertos/semphr.h>
+#include <lwip/sockets.h>
 #include <mbedtls/base64.h>
 #include <sdkconfig.h>
+#include <tracker/BYTETracker.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
-#include <deque>
 #include <memory>
+#include <new>
 #include <utility>
 #include <vector>
 
-#include "BYTETracker.h"
 #include "web_index.h"
 
 #if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
@@ -46,9 +53,13 @@
 #define CMD_TIMEOUT_MS    3000
 
 #if defined(CONFIG_IDF_TARGET_ESP32S3)
-    #define PTR_BUFFER_SIZE     8
+    #define SLOT_SMALL_SIZE     (1024 * 2)
+    #define SLOT_SMALL_COUNT    4
+    #define SLOT_RESULT_SIZE    (1024 * 16)
+    #define SLOT_RESULT_COUNT   4
+    #define SLOT_IMAGE_SIZE     (COM_BUFFER_SIZE + JPG_BUFFER_SIZE)
+    #define SLOT_IMAGE_COUNT    6
     #define COM_BUFFER_SIZE     (1024 * 128)
-    #define RSP_BUFFER_SIZE     (1024 * 196)
     #define JPG_BUFFER_SIZE     (1024 * 128)
     #define RST_BUFFER_SIZE     (1024 * 64)
     #define QRY_BUFFER_SIZE     (1024 * 16)
@@ -57,23 +68,55 @@
     #define BYTE_TRACKER_ENABLED 1
 #else
     #warning "Server may not work properly due to resource constraints..."
-    #define PTR_BUFFER_SIZE     3
+    #define SLOT_SMALL_SIZE     (1024 * 1)
+    #define SLOT_SMALL_COUNT    2
+    #define SLOT_RESULT_SIZE    (1024 * 4)
+    #define SLOT_RESULT_COUNT   2
+    #define SLOT_IMAGE_SIZE     (COM_BUFFER_SIZE + JPG_BUFFER_SIZE)
+    #define SLOT_IMAGE_COUNT    2
     #define COM_BUFFER_SIZE     (1024 * 32)
-    #define RSP_BUFFER_SIZE     (1024 * 32)
     #define JPG_BUFFER_SIZE     (1024 * 32)
     #define RST_BUFFER_SIZE     (1024 * 4)
     #define QRY_BUFFER_SIZE     (1024 * 4)
     #define CMD_BUFFER_SIZE     (1024 * 4)
 
-    #define BYTE_TRACKER_ENABLED 0
+    // opt in with -DBYTE_TRACKER_ENABLED=1, without an FPU the tracker builds in fixed point (BYTE_TRACKER_FIXED_POINT)
+    // and its frame rate on these boards has not been measured yet
+    #ifndef BYTE_TRACKER_ENABLED
+        #define BYTE_TRACKER_ENABLED 0
+    #endif
 #endif
 
+// run the device transport on the library's I/O task, opt in with -DSSCMA_IO_TASK=1
+#ifndef SSCMA_IO_TASK
+    #define SSCMA_IO_TASK 0
+#endif
+
+// place the slot pool in PSRAM when the board has it
+#define SLOT_POOL_PSRAM 1
+
+// stream clients, each sends from a task of its own, extra clients are turned away
+#define STREAM_CLIENTS    4
+#define STREAM_TASK_STACK (1024 * 4)
+#define STREAM_TASK_PRIO  5
+// a client whose socket takes no bytes for this long is dropped
+#define STREAM_STALL_MS   RESULT_TIMEOUT_MS
+
+// detached requests need IDF 5.1, before it the streams run on the server task and a slow client holds up the rest
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+    #define STREAM_ASYNC 1
+#else
+    #define STREAM_ASYNC 0
+#endif
+
+// handlers that can sleep on new slots at once, the rest fall back to polling
+#define SLOT_WAITERS 8
+#define SLOT_POLL_MS 5
+
 #define CMD_TAG_FMT_STR "HTTPD%.8X@"
 #define CMD_TAG_SIZE    snprintf(NULL, 0, CMD_TAG_FMT_STR, 0)
 
-#define MSG_IMAGE_KEY   "\"image\": "
-#define MSG_COMMA_STR   ", "
-#define MSG_QUOTE_STR   "\""
+#define MSG_IMAGE_KEY   "\"image\""
 #define MSG_REPLY_STR   "\"type\": 0"
 #define MSG_EVENT_STR   "\"type\": 1"
 #define MSG_LOGGI_STR   "\"type\": 2"
@@ -86,6 +129,14 @@ enum MsgType : uint16_t {
     MSG_TYPE_LOGGI   = 0xff & (1 << 3),
 };
 
+#define PART_BOUNDARY "123456789000000000000987654321"
+static const char* _STREAM_CONTENT_TYPE = "multipart/x-mixed-replace;boundary=" PART_BOUNDARY;
+static const char* _STREAM_BOUNDARY     = "\r\n--" PART_BOUNDARY "\r\n";
+static const char* _STREAM_PART = "Content-Type: image/jpeg\r\nContent-Length: %u\r\nX-Timestamp: %d.%06d\r\n\r\n";
+
+// bytes reserved in front of each decoded jpeg for the boundary and part header
+#define STREAM_PART_HEADROOM 128
+
 #define CMD_SAMPLE_STR "SAMPLE"
 #define CMD_INVOKE_STR "INVOKE"
 
@@ -96,19 +147,296 @@ enum CmdType : uint16_t {
     CMD_TYPE_SENSOR  = 0xff00 & (3 << 8),
 };
 
+enum SlotClass : uint8_t {
+    SLOT_CLASS_SMALL = 0,  // replies and logs
+    SLOT_CLASS_RESULT,     // events without an image
+    SLOT_CLASS_IMAGE,      // events carrying a frame, plus room for the decoded jpeg
+    SLOT_CLASS_COUNT,
+};
+
+struct SlotClassStats {
+    size_t block_size;
+    size_t blocks;
+    size_t used;       // blocks holding a published response
+    size_t pinned;     // blocks currently held by readers
+    size_t claims;
+    size_t evictions;  // claims that overwrote a published response
+    size_t failures;   // responses dropped, class exhausted or too large
+};
+
+// pool of pre-allocated blocks in a few size classes, one writer (the I/O task) and any number of readers
+// each block is a slot header followed by its data, a class reuses its oldest block no reader holds
+// a reader pins a slot by bumping refs, the writer only claims slots with refs == 0
 struct PtrBuffer {
+    static constexpr uint32_t WRITER = 1u << 31;
+    static constexpr size_t   BLOCKS = SLOT_SMALL_COUNT + SLOT_RESULT_COUNT + SLOT_IMAGE_COUNT;
+
     struct Slot {
-        size_t   id   = 0;
-        uint16_t type = 0;
-        void*    data = NULL;
-        size_t   size = 0;
-        timeval  timestamp;
+        std::atomic<uint32_t> refs{0};
+        std::atomic<size_t>   id{0};  // 0 while empty or being written
+        uint16_t              type      = 0;
+        void*                 data      = NULL;  // points right after the header
+        size_t                size      = 0;
+        size_t                capacity  = 0;
+        const char*           tracked      = NULL;  // tracked INVOKE result right after the raw one, image left empty
+        size_t                tracked_size = 0;
+        const char*           jpeg         = NULL;  // decoded frame, after the responses and the part headroom
+        size_t                jpeg_size    = 0;
+        const char*           part      = NULL;  // boundary, part header and jpeg in one run
+        size_t                part_size = 0;
+        size_t                frame     = 0;  // counts decoded frames only, for drop accounting
+        timeval               timestamp;
     };
 
-    SemaphoreHandle_t                 mutex;
-    std::deque<std::shared_ptr<Slot>> slots;
-    volatile size_t                   id    = 1;
-    const size_t                      limit = PTR_BUFFER_SIZE;
+    // pinned slot, released on destruction
+    class Ref {
+       public:
+        Ref() = default;
+        explicit Ref(Slot* slot) : _slot(slot) {}
+        Ref(Ref&& other) : _slot(other._slot) { other._slot = NULL; }
+        Ref& operator=(Ref&& other) {
+            std::swap(_slot, other._slot);
+            return *this;
+        }
+        Ref(const Ref&)            = delete;
+        Ref& operator=(const Ref&) = delete;
+        ~Ref() {
+            if (_slot != NULL) {
+                _slot->refs.fetch_sub(1);
+            }
+        }
+
+        Slot& operator*() const { return *_slot; }
+        Slot* operator->() const { return _slot; }
+        explicit operator bool() const { return _slot != NULL; }
+
+       private:
+        Slot* _slot = NULL;
+    };
+
+    struct Class {
+        size_t              block_size = 0;
+        size_t              begin      = 0;  // first block in slots
+        size_t              count      = 0;
+        std::atomic<size_t> claims{0};
+        std::atomic<size_t> evictions{0};
+        std::atomic<size_t> failures{0};
+    };
+
+    Slot*               slots[BLOCKS] = {NULL};
+    size_t              limit         = 0;  // blocks actually allocated
+    Class               classes[SLOT_CLASS_COUNT];
+    std::atomic<size_t> id{1};  // id of the next published slot
+    size_t              frames = 0;  // decoded frames so far, only the writer touches it
+
+    static void* allocBlock(size_t size) {
+#if SLOT_POOL_PSRAM
+        if (psramFound()) {
+            void* block = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+            if (block != NULL) {
+                return block;
+            }
+        }
+#endif
+        return malloc(size);
+    }
+
+    void initClass(SlotClass cls, size_t block_size, size_t count) {
+        Class& c     = classes[cls];
+        c.block_size = block_size;
+        c.begin      = limit;
+        for (size_t i = 0; i < count; ++i) {
+            void* block = allocBlock(sizeof(Slot) + block_size);
+            if (block == NULL) {
+                log_e("Failed to allocate slot block, class %u has %u of %u...", cls, i, count);
+                break;
+            }
+            Slot* slot      = new (block) Slot();
+            slot->data      = slot + 1;
+            slot->capacity  = block_size;
+            slots[limit++]  = slot;
+            c.count        += 1;
+        }
+    }
+
+    void init() {
+        initClass(SLOT_CLASS_SMALL, SLOT_SMALL_SIZE, SLOT_SMALL_COUNT);
+        initClass(SLOT_CLASS_RESULT, SLOT_RESULT_SIZE, SLOT_RESULT_COUNT);
+        initClass(SLOT_CLASS_IMAGE, SLOT_IMAGE_SIZE, SLOT_IMAGE_COUNT);
+    }
+
+    // oldest block of the class no reader holds, NULL when every block is pinned
+    Slot* claimFrom(Class& c) {
+        for (size_t tries = 0; tries < c.count; ++tries) {
+            Slot* oldest = NULL;
+            for (size_t i = c.begin; i < c.begin + c.count; ++i) {
+                if (slots[i]->refs.load() == 0 && (oldest == NULL || slots[i]->id.load() < oldest->id.load())) {
+                    oldest = slots[i];
+                }
+            }
+            if (oldest == NULL) {
+                return NULL;
+            }
+            uint32_t expected = 0;
+            if (oldest->refs.compare_exchange_strong(expected, WRITER)) {
+                c.claims += 1;
+                if (oldest->id.exchange(0) != 0) {
+                    c.evictions += 1;
+                }
+                return oldest;
+            }
+        }
+        return NULL;
+    }
+
+    // block for a response of len bytes, spills into the larger classes when its own is exhausted
+    Slot* claim(SlotClass cls, size_t len) {
+        for (uint8_t i = cls; i < SLOT_CLASS_COUNT; ++i) {
+            Class& c = classes[i];
+            if (c.block_size < len) {
+                continue;
+            }
+            if (Slot* slot = claimFrom(c)) {
+                return slot;
+            }
+        }
+        classes[cls].failures += 1;
+        return NULL;
+    }
+
+    void publish(Slot* slot) {
+        slot->id.store(id.fetch_add(1));
+        slot->refs.fetch_sub(WRITER);
+        notify(slot->type);
+    }
+
+    // tasks sleeping until a slot whose type matches their mask is published
+    struct Waiter {
+        std::atomic<TaskHandle_t> task{NULL};
+        std::atomic<uint16_t>     mask{0};
+    };
+
+    Waiter waiters[SLOT_WAITERS];
+
+    void notify(uint16_t type) {
+        for (size_t i = 0; i < SLOT_WAITERS; ++i) {
+            TaskHandle_t task = waiters[i].task.load();
+            if (task != NULL && waiters[i].mask.load() & type) {
+                xTaskNotifyGive(task);
+            }
+        }
+    }
+
+    // registers the calling task for the lifetime of the object, register before checking the ring
+    // so a slot published in between is not missed, the notification stays pending until wait()
+    class Wakeup {
+       public:
+        Wakeup(PtrBuffer& pb, uint16_t mask) {
+            TaskHandle_t self = xTaskGetCurrentTaskHandle();
+            for (size_t i = 0; i < SLOT_WAITERS; ++i) {
+                TaskHandle_t expected = NULL;
+                if (pb.waiters[i].task.compare_exchange_strong(expected, self)) {
+                    _waiter = &pb.waiters[i];
+                    _waiter->mask.store(mask);
+                    break;
+                }
+            }
+            if (_waiter == NULL) {
+                log_w("No free waiter, polling every %u ms...", SLOT_POLL_MS);
+            }
+        }
+        Wakeup(const Wakeup&)            = delete;
+        Wakeup& operator=(const Wakeup&) = delete;
+        ~Wakeup() {
+            if (_waiter != NULL) {
+                _waiter->mask.store(0);
+                _waiter->task.store(NULL);
+                ulTaskNotifyTake(pdTRUE, 0);
+            }
+        }
+
+        // sleep until a matching slot is published or ticks pass
+        void wait(TickType_t ticks) {
+            if (_waiter == NULL) {
+                vTaskDelay(std::min<TickType_t>(ticks, SLOT_POLL_MS / portTICK_PERIOD_MS));
+                return;
+            }
+            ulTaskNotifyTake(pdTRUE, ticks);
+        }
+
+       private:
+        Waiter* _waiter = NULL;
+    };
+
+    SlotClassStats stats(SlotClass cls) const {
+        const Class&   c = classes[cls];
+        SlotClassStats st{c.block_size, c.count, 0, 0, c.claims.load(), c.evictions.load(), c.failures.load()};
+        for (size_t i = c.begin; i < c.begin + c.count; ++i) {
+            uint32_t refs = slots[i]->refs.load();
+            st.used += slots[i]->id.load() != 0;
+            st.pinned += (refs & ~WRITER) != 0;
+        }
+        return st;
+    }
+
+    // pin a slot only if it still holds the id the caller looked at
+    Ref pin(Slot* slot, size_t slot_id) {
+        if (slot->refs.fetch_add(1) & WRITER || slot->id.load() != slot_id) {
+            slot->refs.fetch_sub(1);
+            return Ref();
+        }
+        return Ref(slot);
+    }
+
+    // newest slot after cursor that match accepts, advances cursor past it
+    template <typename Match> Ref latest(size_t& cursor, Match match) {
+        for (;;) {
+            Slot*  best    = NULL;
+            size_t best_id = cursor;
+            for (size_t i = 0; i < limit; ++i) {
+                size_t slot_id = slots[i]->id.load();
+                if (slot_id > best_id && match(*slots[i])) {
+                    best    = slots[i];
+                    best_id = slot_id;
+                }
+            }
+            if (best == NULL) {
+                return Ref();
+            }
+            Ref ref = pin(best, best_id);
+            if (ref) {
+                cursor = best_id;
+                return ref;
+            }
+        }
+    }
+
+    // any slot after cursor that match accepts, cursor is left alone
+    template <typename Match> Ref find(size_t cursor, Match match) {
+        for (size_t i = 0; i < limit; ++i) {
+            size_t slot_id = slots[i]->id.load();
+            if (slot_id <= cursor) {
+                continue;
+            }
+            Ref ref = pin(slots[i], slot_id);
+            if (ref && match(*ref)) {
+                return ref;
+            }
+        }
+        return Ref();
+    }
+};
+
+// pacing and counters of one stream client, counters are written by its sender only
+struct StreamClient {
+    std::atomic<int>      fd{-1};  // -1 when free
+    std::atomic<bool>     results{false};  // /stream/result rather than /stream/frame
+    std::atomic<uint32_t> fps_limit{0};
+    std::atomic<uint32_t> kbps_limit{0};
+    std::atomic<uint32_t> frames{0};
+    std::atomic<uint32_t> dropped{0};  // decoded frames this client never got
+    std::atomic<uint32_t> bytes{0};
+    std::atomic<uint32_t> fps_x100{0};  // measured, smoothed
 };
 
 struct StatInfo {
@@ -117,11 +445,35 @@ struct StatInfo {
     SemaphoreHandle_t mutex;
 };
 
-PtrBuffer PB;
-StatInfo  SI;
-SSCMA     AI;
+PtrBuffer    PB;
+StatInfo     SI;
+SSCMA        AI;
+StreamClient SC[STREAM_CLIENTS];
+
+static StreamClient* acquireStreamClient(int fd, bool results) {
+    for (size_t i = 0; i < STREAM_CLIENTS; ++i) {
+        int expected = -1;
+        if (SC[i].fd.compare_exchange_strong(expected, fd)) {
+            SC[i].results    = results;
+            SC[i].fps_limit  = 0;
+            SC[i].kbps_limit = 0;
+            SC[i].frames     = 0;
+            SC[i].dropped    = 0;
+            SC[i].bytes      = 0;
+            SC[i].fps_x100   = 0;
+            return &SC[i];
+        }
+    }
+    return NULL;
+}
+
+static void releaseStreamClient(StreamClient* client) {
+    if (client != NULL) {
+        client->fd = -1;
+    }
+}
 
-void initSharedBuffer() { PB.mutex = xSemaphoreCreateMutex(); }
+void initSharedBuffer() { PB.init(); }
 
 void initStatInfo() {
     SI.mutex                        = xSemaphoreCreateMutex();
@@ -130,6 +482,8 @@ void initStatInfo() {
     SI.last_frame_timestamp.tv_usec = (ticks % configTICK_RATE_HZ) * 1e6 / configTICK_RATE_HZ;
 }
 
+static void proxyCallback(const char* resp, size_t len);
+
 void startRemoteProxy(Proto through = PROTO_UART) {
     switch (through) {
     case PROTO_UART: {
@@ -161,6 +515,13 @@ void startRemoteProxy(Proto through = PROTO_UART) {
     default:
         assert(false && "Unknown proto...");
     }
+
+#if SSCMA_IO_TASK
+    // the I/O task owns the transport from here, handlers go through AI.submit()
+    if (!AI.start_io_task(proxyCallback)) {
+        log_e("Failed to start I/O task...");
+    }
+#endif
 }
 
 inline uint16_t getMsgType(const char* resp, size_t len) {
@@ -191,6 +552,139 @@ inline uint16_t getCmdType(const char* resp, size_t len) {
     return type;
 }
 
+#if BYTE_TRACKER_ENABLED
+// one tracker fed from the I/O task, so every client sees the same track ids
+static BYTETracker                      tracker;
+static std::vector<BYTETracker::Object> tracker_objects;
+static std::vector<JsonArray>           tracker_boxes;  // json box of each tracker object
+
+// the device sends box centers and 0..100 scores, the tracker takes top left corners and 0..1, as in
+// SSCMAByteTracker
+static BYTETracker::Object trackerObject(JsonArray box) {
+    BYTETracker::Object object;
+    object.rect.width  = box[2].as<float>();
+    object.rect.height = box[3].as<float>();
+    object.rect.x      = box[0].as<float>() - object.rect.width / 2;
+    object.rect.y      = box[1].as<float>() - object.rect.height / 2;
+    object.prob        = box[4].as<float>() / 100;
+    object.label       = box[5];
+    return object;
+}
+
+// x, y, w, h, score, target and track id of a track, back in the device's format
+static void trackedBox(const STrack& strack, int32_t out[7]) {
+    float w = static_cast<float>(strack.tlwh[2]);
+    float h = static_cast<float>(strack.tlwh[3]);
+    out[0]  = lroundf(static_cast<float>(strack.tlwh[0]) + w / 2);
+    out[1]  = lroundf(static_cast<float>(strack.tlwh[1]) + h / 2);
+    out[2]  = lroundf(w);
+    out[3]  = lroundf(h);
+    out[4]  = lroundf(strack.score * 100);
+    out[5]  = strack.label;
+    out[6]  = strack.track_id;
+}
+
+// rewrites the boxes or keypoints of an INVOKE event with tracked positions and track ids
+static void trackResponse(JsonDocument& response) {
+    int32_t tracked[7];
+
+    tracker_objects.clear();
+    if (response["data"].containsKey("boxes")) {
+        JsonArray boxes = response["data"]["boxes"];
+        for (JsonArray box : boxes) {
+            if (box.size() != 6) {
+                log_w("Invalid box size...");
+                continue;
+            }
+            tracker_objects.push_back(trackerObject(box));
+        }
+
+        const std::vector<STrack>& output_stracks = tracker.update(tracker_objects);
+
+        boxes.clear();
+        for (const STrack& strack : output_stracks) {
+            JsonDocument doc;
+            JsonArray    box = doc.to<JsonArray>();
+            trackedBox(strack, tracked);
+            for (int32_t value : tracked) {
+                box.add(value);
+            }
+            boxes.add(box);
+        }
+
+    } else if (response["data"].containsKey("keypoints")) {
+        JsonArray keypoints = response["data"]["keypoints"];
+
+        tracker_boxes.clear();
+        for (JsonArray keypoint : keypoints) {
+            if (keypoint.size() != 2) {
+                log_w("Invalid keypoint size...");
+                continue;
+            }
+            JsonArray box = keypoint[0];
+            if (box.size() != 6) {
+                log_w("Invalid box size...");
+                continue;
+            }
+            tracker_objects.push_back(trackerObject(box));
+            tracker_boxes.push_back(box);
+        }
+
+        const std::vector<STrack>& output_stracks = tracker.update(tracker_objects);
+
+        // boxes without a confirmed track keep their detection and get track id 0
+        for (JsonArray box : tracker_boxes) {
+            box.add(0);
+        }
+        for (const STrack& strack : output_stracks) {
+            JsonArray box = tracker_boxes[strack.object];
+            trackedBox(strack, tracked);
+            for (size_t i = 0; i < 7; ++i) {
+                box[i] = tracked[i];
+            }
+        }
+    }
+}
+#endif
+
+// finds "image": "..." in pretty or minified json, returns the base64 value or NULL
+// head and tail, when given, bound the whole member from the key to past the closing quote
+static const char* findImageValue(const char* data, size_t size, const char** head, const char** tail) {
+    const char* key = strnstr(data, MSG_IMAGE_KEY, size);
+    if (head != NULL) {
+        *head = key;
+    }
+    if (key == NULL) {
+        return NULL;
+    }
+    const char* end = data + size;
+    const char* p   = key + strlen(MSG_IMAGE_KEY);
+    while (p < end && isspace((unsigned char)*p)) {
+        ++p;
+    }
+    if (p >= end || *p++ != ':') {
+        return NULL;
+    }
+    while (p < end && isspace((unsigned char)*p)) {
+        ++p;
+    }
+    if (p >= end || *p++ != '"') {
+        return NULL;
+    }
+    const char* quote = (const char*)memchr(p, '"', end - p);
+    if (quote == NULL) {
+        return NULL;
+    }
+    if (tail != NULL) {
+        *tail = quote + 1;
+    }
+    return p;
+}
+
+inline bool isFrameSlot(const PtrBuffer::Slot& slot) {
+    return slot.type == (MSG_TYPE_EVENT | CMD_TYPE_SAMPLE) || slot.type == (MSG_TYPE_EVENT | CMD_TYPE_INVOKE);
+}
+
 static void proxyCallback(const char* resp, size_t len) {
     static timeval timestamp;
     TickType_t     ticks = xTaskGetTickCount();
@@ -209,64 +703,117 @@ static void proxyCallback(const char* resp, size_t len) {
     }
     type |= getCmdType(resp, len);
 
-    char* copy = (char*)malloc(len);
-    if (copy == NULL) {
-        log_e("Failed to allocate resp copy...");
-        return;
+    // the base64 image is decoded once here and shared by every stream client
+    const char* image     = NULL;
+    size_t      image_len = 0;
+    SlotClass   cls       = SLOT_CLASS_SMALL;
+    if (type & MSG_TYPE_EVENT) {
+        const char* tail = NULL;
+        cls              = SLOT_CLASS_RESULT;
+        image            = findImageValue(resp, len, NULL, &tail);
+        if (image != NULL) {
+            image_len = tail - 1 - image;
+            cls       = SLOT_CLASS_IMAGE;
+        }
     }
-    memcpy(copy, resp, len);
 
-    size_t           limit  = PB.limit;
-    PtrBuffer::Slot* p_slot = (PtrBuffer::Slot*)malloc(sizeof(PtrBuffer::Slot));
-    if (p_slot == NULL) {
-        log_e("Failed to allocate slot...");
-        return;
+    // the tracked result is serialized once into the slot after the raw response, which /result keeps serving
+    size_t tracked_size = 0;
+#if BYTE_TRACKER_ENABLED
+    static JsonDocument tracked;
+    if (type == (MSG_TYPE_EVENT | CMD_TYPE_INVOKE)) {
+        tracked.clear();
+        DeserializationError err = deserializeJson(tracked, resp, len);
+        if (err != DeserializationError::Ok) {
+            log_e("Failed to parse json...");
+        } else if (!tracked.containsKey("data")) {
+            log_e("No data found in json...");
+        } else {
+            trackResponse(tracked);
+            if (image != NULL) {
+                tracked["data"]["image"] = "";  // spliced back from the raw response when streamed
+            }
+            tracked_size = measureJson(tracked);
+        }
+    }
+#endif
+
+    size_t jpeg_room = (image_len / 4 + 1) * 3;
+    if (jpeg_room > JPG_BUFFER_SIZE) {
+        jpeg_room = JPG_BUFFER_SIZE;
     }
 
-    p_slot->id        = PB.id;
-    p_slot->type      = type;
-    p_slot->data      = copy;
-    p_slot->size      = len;
-    p_slot->timestamp = timestamp;
+    size_t           size = len + tracked_size;
+    PtrBuffer::Slot* slot = PB.claim(cls, size + 1 + (image_len ? STREAM_PART_HEADROOM + jpeg_room : 0));
+    if (slot == NULL) {
+        log_i("No free slot of class %u for %u bytes, discarded response...", cls, size);
+        return;
+    }
+    memcpy(slot->data, resp, len);
 
-    size_t discarded = 0;
-    xSemaphoreTake(PB.mutex, portMAX_DELAY);
-    while (PB.slots.size() >= limit) {
-        PB.slots.pop_front();
-        discarded += 1;
+    slot->tracked      = NULL;
+    slot->tracked_size = 0;
+#if BYTE_TRACKER_ENABLED
+    if (tracked_size) {
+        slot->tracked      = (const char*)slot->data + len;
+        slot->tracked_size = serializeJson(tracked, (char*)slot->data + len, slot->capacity - len);
     }
-    PB.slots.emplace_back(std::shared_ptr<PtrBuffer::Slot>(p_slot, [](PtrBuffer::Slot* p) {
-        if (p == NULL) {
-            return;
-        }
-        if (p->data != NULL) {
-            free(p->data);
-            p->data = NULL;
-        }
-        free(p);
-    }));
-    xSemaphoreGive(PB.mutex);
-    PB.id += 1;
+#endif
 
-    if (discarded > 0) {
-        log_i("Discarded %u old responses...", discarded);
+    slot->jpeg      = NULL;
+    slot->jpeg_size = 0;
+    slot->part      = NULL;
+    slot->part_size = 0;
+    if (image_len) {
+        size_t         offset    = size + STREAM_PART_HEADROOM;
+        unsigned char* jpeg      = (unsigned char*)slot->data + offset;
+        size_t         jpeg_size = 0;
+        if (mbedtls_base64_decode(
+              jpeg, slot->capacity - offset, &jpeg_size, (const unsigned char*)image, image_len) == 0) {
+            slot->jpeg      = (const char*)jpeg;
+            slot->jpeg_size = jpeg_size;
+            slot->frame     = ++PB.frames;
+
+            // render boundary and part header right in front of the jpeg, so a client sends the part in one go
+            char   head[STREAM_PART_HEADROOM];
+            size_t blen = strlen(_STREAM_BOUNDARY);
+            memcpy(head, _STREAM_BOUNDARY, blen);
+            size_t hlen = blen + snprintf(head + blen,
+                                          sizeof(head) - blen,
+                                          _STREAM_PART,
+                                          jpeg_size,
+                                          timestamp.tv_sec,
+                                          timestamp.tv_usec);
+            if (hlen < sizeof(head)) {
+                memcpy(jpeg - hlen, head, hlen);
+                slot->part      = (const char*)jpeg - hlen;
+                slot->part_size = hlen + jpeg_size;
+            }
+        } else {
+            log_e("Failed to decode image data...");
+        }
     }
 
+    slot->type      = type;
+    slot->size      = len;
+    slot->timestamp = timestamp;
+    PB.publish(slot);
+
     log_i("Received %u bytes...", len);
 }
 
-void loopRemoteProxy() { AI.fetch(proxyCallback); }
+void loopRemoteProxy() {
+    if (AI.io_task_running()) {
+        return;
+    }
+    AI.fetch(proxyCallback);
+}
 
 typedef struct {
     httpd_req_t* req;
     size_t       len;
 } jpg_chunking_t;
 
-#define PART_BOUNDARY "123456789000000000000987654321"
-static const char* _STREAM_CONTENT_TYPE = "multipart/x-mixed-replace;boundary=" PART_BOUNDARY;
-static const char* _STREAM_BOUNDARY     = "\r\n--" PART_BOUNDARY "\r\n";
-static const char* _STREAM_PART = "Content-Type: image/jpeg\r\nContent-Length: %u\r\nX-Timestamp: %d.%06d\r\n\r\n";
-
 httpd_handle_t web_httpd    = NULL;
 httpd_handle_t stream_httpd = NULL;
 
@@ -324,81 +871,67 @@ static esp_err_t results_handler(httpd_req_t* req) {
         }
     }
 
-    std::shared_ptr<PtrBuffer::Slot> slot = nullptr;
+    PtrBuffer::Ref    slot;
+    PtrBuffer::Wakeup wakeup(PB, MSG_TYPE_EVENT);
 
     TickType_t time_begin = xTaskGetTickCount();
-    while ((xTaskGetTickCount() - time_begin) < RESULT_TIMEOUT_MS) {
-        xSemaphoreTake(PB.mutex, portMAX_DELAY);
-        auto slots = PB.slots;
-        xSemaphoreGive(PB.mutex);
-
-        for (auto it = slots.rbegin(); it != slots.rend(); ++it) {
-            if (it->get()->id <= last_id) {
-                break;
-            }
-            if (it->get()->type == (MSG_TYPE_EVENT | CMD_TYPE_SAMPLE) ||
-                it->get()->type == (MSG_TYPE_EVENT | CMD_TYPE_INVOKE)) {
-                slot    = *it;
-                last_id = slot->id;
-                break;
-            }
-        }
-
-        if (!slot) {
-            vTaskDelay(5 / portTICK_PERIOD_MS);
-            continue;
+    TickType_t timeout    = RESULT_TIMEOUT_MS / portTICK_PERIOD_MS;
+    TickType_t elapsed    = 0;
+    while ((elapsed = xTaskGetTickCount() - time_begin) < timeout) {
+        slot = PB.latest(last_id, isFrameSlot);
+        if (slot) {
+            break;
         }
-
-        break;
+        wakeup.wait(timeout - elapsed);
     }
 
-    if (slot == nullptr) {
+    if (!slot) {
         log_w("Find newer results slot timeout...");
         httpd_resp_send_500(req);
         return ESP_OK;
     }
 
-    const char* img_head = strnstr((const char*)slot->data, MSG_IMAGE_KEY MSG_QUOTE_STR, slot->size);
+    // strip the image, with the comma that separates it from its neighbour
+    const char* data     = (const char*)slot->data;
+    const char* img_head = NULL;
+    const char* img_tail = NULL;
+    const char* value    = findImageValue(data, slot->size, &img_head, &img_tail);
     if (img_head != NULL) {
-        size_t offset = (img_head - (const char*)slot->data) + strlen(MSG_IMAGE_KEY MSG_QUOTE_STR);
-
-        bool        found_prefix_comma = false;
-        const char* img_head_full      = img_head - strlen(MSG_COMMA_STR);
-        if (img_head_full >= (const char*)slot->data) {
-            if (strncmp(img_head_full, MSG_COMMA_STR, strlen(MSG_COMMA_STR)) == 0) {
-                img_head           = img_head_full;
-                found_prefix_comma = true;
-            }
-        }
-
-        const char* img_tail = strnstr((const char*)slot->data + offset, MSG_QUOTE_STR, slot->size - offset);
-        if (img_tail == NULL) {
+        if (value == NULL) {
             log_e("Broken json format...");
             httpd_resp_send_500(req);
             return ESP_OK;
         }
-        offset = (img_tail - (const char*)slot->data) + strlen(MSG_QUOTE_STR);
 
-        if (!found_prefix_comma) {
-            const char* img_tail_full = strnstr((const char*)slot->data + offset, MSG_COMMA_STR, slot->size - offset);
-            if (img_tail_full != NULL) {
-                img_tail = img_tail_full;
+        const char* prev = img_head;
+        while (prev > data && isspace((unsigned char)prev[-1])) {
+            --prev;
+        }
+        if (prev > data && prev[-1] == ',') {
+            img_head = prev - 1;
+        } else {
+            const char* next = img_tail;
+            while (next < data + slot->size && isspace((unsigned char)*next)) {
+                ++next;
+            }
+            if (next < data + slot->size && *next == ',') {
+                img_tail = next + 1;
             }
         }
+    } else {
+        img_head = img_tail = data + slot->size;
+    }
 
-        if (slot->size - (img_tail - img_head) >= RST_BUFFER_SIZE) {
-            log_e("Results buffer is not enough...");
-            httpd_resp_send_500(req);
-            return ESP_OK;
-        }
-        memset(rst_buf, 0, RST_BUFFER_SIZE);
-        size_t size   = img_head - (const char*)slot->data;
-        size_t copied = 0;
-        strncpy(rst_buf, (const char*)slot->data, size);
-        copied += size;
-        size = ((const char*)slot->data + slot->size) - img_tail;
-        strncpy(rst_buf + copied, img_tail, size);
+    if (slot->size - (img_tail - img_head) >= RST_BUFFER_SIZE) {
+        log_e("Results buffer is not enough...");
+        httpd_resp_send_500(req);
+        return ESP_OK;
     }
+    size_t head_size = img_head - data;
+    size_t tail_size = (data + slot->size) - img_tail;
+    memcpy(rst_buf, data, head_size);
+    memcpy(rst_buf + head_size, img_tail, tail_size);
+    rst_buf[head_size + tail_size] = '\0';
 
     httpd_resp_set_type(req, "application/json");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
@@ -435,79 +968,106 @@ static esp_err_t results_handler(httpd_req_t* req) {
     return res;
 }
 
-static esp_err_t stream_frame_handler(httpd_req_t* req) {
-    esp_err_t res = ESP_OK;
-    char*     part_buf[128];
-    char*     jpeg_buf = NULL;
-    size_t    last_id  = 0;
+typedef esp_err_t (*StreamLoop)(httpd_req_t* req, StreamClient* client);
 
-    res = httpd_resp_set_type(req, _STREAM_CONTENT_TYPE);
+#if STREAM_ASYNC
+struct StreamTask {
+    httpd_req_t*  req;
+    StreamClient* client;
+    StreamLoop    loop;
+};
+
+static void streamTask(void* arg) {
+    StreamTask* task = (StreamTask*)arg;
+    task->loop(task->req, task->client);
+    releaseStreamClient(task->client);
+    httpd_req_async_handler_complete(task->req);
+    free(task);
+    vTaskDelete(NULL);
+}
+#endif
+
+// hands the request over to a sender task of its own, so a client stuck in a send only holds up itself
+// and the server task goes back to the other sockets; the headers go out here with a preamble the client
+// ignores, the detached copy then only sends body chunks
+static esp_err_t startStream(
+  httpd_req_t* req, StreamClient* client, StreamLoop loop, const char* name, const char* preamble) {
+    esp_err_t res = httpd_resp_send_chunk(req, preamble, strlen(preamble));
     if (res != ESP_OK) {
+        releaseStreamClient(client);
         return res;
     }
-
-    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    httpd_resp_set_hdr(req, "X-Framerate", "60");
-
-    jpeg_buf = (char*)malloc(JPG_BUFFER_SIZE);
-    if (jpeg_buf == NULL) {
-        log_e("Failed to allocate jpeg buffer...");
-        return ESP_ERR_NO_MEM;
+#if STREAM_ASYNC
+    StreamTask* task = (StreamTask*)malloc(sizeof(StreamTask));
+    if (task != NULL && httpd_req_async_handler_begin(req, &task->req) == ESP_OK) {
+        task->client = client;
+        task->loop   = loop;
+        if (xTaskCreate(streamTask, name, STREAM_TASK_STACK, task, STREAM_TASK_PRIO, NULL) == pdPASS) {
+            return ESP_OK;
+        }
+        httpd_req_async_handler_complete(task->req);
     }
+    free(task);
+    releaseStreamClient(client);
+    log_e("Failed to start stream task...");
+    return ESP_FAIL;
+#else
+    (void)name;
+    res = loop(req, client);
+    releaseStreamClient(client);
+    return res;
+#endif
+}
 
-    while (true) {
-        std::shared_ptr<PtrBuffer::Slot> slot = nullptr;
+static esp_err_t rejectStream(httpd_req_t* req) {
+    log_w("Too many stream clients...");
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    return httpd_resp_send(req, NULL, 0);
+}
 
-        {
-            xSemaphoreTake(PB.mutex, portMAX_DELAY);
-            auto slots = PB.slots;
-            xSemaphoreGive(PB.mutex);
+// waits until the socket takes bytes again without sending anything, the caller then picks the newest slot,
+// so whatever was published while the client was congested is skipped instead of queued
+static bool streamWritable(httpd_req_t* req, uint32_t timeout_ms) {
+    int    fd = httpd_req_to_sockfd(req);
+    fd_set set;
+    FD_ZERO(&set);
+    FD_SET(fd, &set);
+    timeval tv = {.tv_sec = (time_t)(timeout_ms / 1000), .tv_usec = (suseconds_t)(timeout_ms % 1000) * 1000};
+    return select(fd + 1, NULL, &set, NULL, &tv) > 0;
+}
 
-            for (auto it = slots.rbegin(); it != slots.rend(); ++it) {
-                if (it->get()->id <= last_id) {
-                    break;
-                }
-                if (it->get()->type == (MSG_TYPE_EVENT | CMD_TYPE_SAMPLE) ||
-                    it->get()->type == (MSG_TYPE_EVENT | CMD_TYPE_INVOKE)) {
-                    slot    = *it;
-                    last_id = slot->id;
-                    break;
-                }
-            }
+static esp_err_t streamFrames(httpd_req_t* req, StreamClient* client) {
+    esp_err_t res     = ESP_OK;
+    size_t    last_id = 0;
 
-            if (!slot) {
-                vTaskDelay(5 / portTICK_PERIOD_MS);
-                continue;
-            }
-        }
+    PtrBuffer::Wakeup wakeup(PB, MSG_TYPE_EVENT);
 
-        const char* slice = strnstr((const char*)slot->data, MSG_IMAGE_KEY MSG_QUOTE_STR, slot->size);
-        if (slice == NULL) {
-            log_w("No image data found...");
-            vTaskDelay(5 / portTICK_PERIOD_MS);
-            continue;
+    size_t  last_frame = 0;
+    int64_t next_us    = 0;  // earliest time the next frame may go out
+    int64_t last_us    = 0;
+    float   fps        = 0;
+
+    while (true) {
+        // pace and wait for the socket first, then take whatever is newest, a slot is only pinned while
+        // its bytes are going out
+        int64_t now_us = esp_timer_get_time();
+        if (next_us > now_us) {
+            vTaskDelay(std::max<TickType_t>(1, (next_us - now_us) / 1000 / portTICK_PERIOD_MS));
         }
-        size_t      offset = (slice - (const char*)slot->data) + strlen(MSG_IMAGE_KEY MSG_QUOTE_STR);
-        const char* data   = (const char*)slot->data + offset;
-        const char* quote  = strnstr(data, MSG_QUOTE_STR, slot->size - offset);
-        if (quote == NULL) {
-            log_w("Invalid image data size...");
-            vTaskDelay(5 / portTICK_PERIOD_MS);
-            continue;
+        if (!streamWritable(req, STREAM_STALL_MS)) {
+            log_w("Stream client stalled, dropping it...");
+            res = ESP_FAIL;
+            break;
         }
-        size_t len = quote - data;
-        if (len == 0) {
-            log_w("Empty image data...");
-            vTaskDelay(5 / portTICK_PERIOD_MS);
+
+        PtrBuffer::Ref slot = PB.latest(last_id, isFrameSlot);
+        if (!slot) {
+            wakeup.wait(RESULT_TIMEOUT_MS / portTICK_PERIOD_MS);
             continue;
         }
 
-        size_t jpeg_size = 0;
-        memset(jpeg_buf, 0, JPG_BUFFER_SIZE);
-        if (mbedtls_base64_decode(
-              (unsigned char*)jpeg_buf, JPG_BUFFER_SIZE, &jpeg_size, (const unsigned char*)data, len) != 0) {
-            log_e("Failed to decode image data...");
-            vTaskDelay(5 / portTICK_PERIOD_MS);
+        if (slot->part == NULL || slot->part_size == 0) {
+            log_w("No image data found...");
             continue;
         }
 
@@ -516,234 +1076,148 @@ static esp_err_t stream_frame_handler(httpd_req_t* req) {
         SI.last_frame_timestamp = slot->timestamp;
         xSemaphoreGive(SI.mutex);
 
-        res = httpd_resp_send_chunk(req, _STREAM_BOUNDARY, strlen(_STREAM_BOUNDARY));
+        res = httpd_resp_send_chunk(req, slot->part, slot->part_size);
         if (res != ESP_OK) {
-            goto SendError;
+            log_e("Send frame failed...");
+            break;
         }
 
-        {
-            memset(part_buf, 0, sizeof(part_buf));
-            size_t hlen = snprintf((char*)part_buf,
-                                   sizeof(part_buf),
-                                   _STREAM_PART,
-                                   jpeg_size,
-                                   slot->timestamp.tv_sec,
-                                   slot->timestamp.tv_usec);
-            res         = httpd_resp_send_chunk(req, (const char*)part_buf, hlen);
+        uint32_t fps_limit  = client->fps_limit;
+        uint32_t kbps_limit = client->kbps_limit;
+        size_t   sent       = slot->part_size;
+        now_us              = esp_timer_get_time();
+        next_us             = now_us;
+        if (fps_limit > 0) {
+            next_us = std::max<int64_t>(next_us, now_us + 1000000 / fps_limit);
         }
-        if (res != ESP_OK) {
-            goto SendError;
+        if (kbps_limit > 0) {
+            next_us = std::max<int64_t>(next_us, now_us + (int64_t)sent * 8000 / kbps_limit);
         }
-
-        res = httpd_resp_send_chunk(req, jpeg_buf, jpeg_size);
-        if (res != ESP_OK) {
-            goto SendError;
+        if (last_us > 0) {
+            fps = fps * 0.9f + 0.1f * 1e6f / (float)(now_us - last_us);
         }
+        last_us = now_us;
 
-        continue;
-
-    SendError:
-        log_e("Send frame failed...");
-        break;
+        client->frames += 1;
+        client->bytes += sent;
+        client->fps_x100 = (uint32_t)(fps * 100);
+        if (last_frame > 0 && slot->frame > last_frame + 1) {
+            client->dropped += slot->frame - last_frame - 1;
+        }
+        last_frame = slot->frame;
     }
 
-    free(jpeg_buf);
-
     return res;
 }
 
-static esp_err_t stream_result_handler(httpd_req_t* req) {
-    esp_err_t     res     = ESP_OK;
-    static size_t last_id = 0;
-
-#if BYTE_TRACKER_ENABLED
-    JsonDocument                     response;
-    BYTETracker                      tracker;
-    std::vector<BYTETracker::Object> boxes_list;
-    static char*                     rsp_buf = NULL;
-    if (rsp_buf == NULL) {
-        rsp_buf = (char*)malloc(RSP_BUFFER_SIZE);
-        if (rsp_buf == NULL) {
-            log_e("Failed to allocate response buffer...");
-            httpd_resp_send_500(req);
-            return ESP_ERR_NO_MEM;
-        }
-    }
-#endif
+static esp_err_t stream_frame_handler(httpd_req_t* req) {
+    esp_err_t res = ESP_OK;
 
-    res |= httpd_resp_set_status(req, HTTPD_200);
-    res |= httpd_resp_set_type(req, "application/json");
-    res |= httpd_resp_set_hdr(req, "Connection", "keep-alive");
-    res |= httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    res = httpd_resp_set_type(req, _STREAM_CONTENT_TYPE);
     if (res != ESP_OK) {
-        log_e("Failed to set response headers...");
         return res;
     }
 
-    while (res == ESP_OK) {
-        std::shared_ptr<PtrBuffer::Slot> slot = nullptr;
-
-        xSemaphoreTake(PB.mutex, portMAX_DELAY);
-        auto slots = PB.slots;
-        xSemaphoreGive(PB.mutex);
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "X-Framerate", "60");
 
-        for (auto it = slots.rbegin(); it != slots.rend(); ++it) {
-            if (it->get()->id <= last_id) {
-                break;
-            }
-            if (it->get()->type == (MSG_TYPE_EVENT | CMD_TYPE_SAMPLE) ||
-                it->get()->type == (MSG_TYPE_EVENT | CMD_TYPE_INVOKE)) {
-                slot    = *it;
-                last_id = slot->id;
-                break;
-            }
-        }
+    StreamClient* client = acquireStreamClient(httpd_req_to_sockfd(req), false);
+    if (client == NULL) {
+        return rejectStream(req);
+    }
 
-        if (!slot) {
-            vTaskDelay(5 / portTICK_PERIOD_MS);
-            continue;
+    // optional ?fps=N&kbps=N caps for this client
+    char qry[64] = {0};
+    char val[16] = {0};
+    if (httpd_req_get_url_query_str(req, qry, sizeof(qry)) == ESP_OK) {
+        if (httpd_query_key_value(qry, "fps", val, sizeof(val)) == ESP_OK) {
+            client->fps_limit = strtoul(val, NULL, 10);
         }
-
-        switch (slot->type) {
-        case MSG_TYPE_EVENT | CMD_TYPE_SAMPLE: {
-            res |= httpd_resp_send_chunk(req, (const char*)slot->data, slot->size);
-            res |= httpd_resp_send_chunk(req, MSG_TERMI_STR, strlen(MSG_TERMI_STR));
-            break;
+        if (httpd_query_key_value(qry, "kbps", val, sizeof(val)) == ESP_OK) {
+            client->kbps_limit = strtoul(val, NULL, 10);
         }
+    }
 
-        case MSG_TYPE_EVENT | CMD_TYPE_INVOKE: {
-#if !BYTE_TRACKER_ENABLED
-            res |= httpd_resp_send_chunk(req, (const char*)slot->data, slot->size);
-            res |= httpd_resp_send_chunk(req, MSG_TERMI_STR, strlen(MSG_TERMI_STR));
-            break;
-#else
-            response.clear();
-            DeserializationError err = deserializeJson(response, (const char*)slot->data, slot->size);
-            if (err != DeserializationError::Ok) {
-                log_e("Failed to parse json...");
-                log_e("%s\n", (const char*)slot->data);
-                break;
-            }
-
-            if (!response.containsKey("data")) {
-                log_e("No data found in json...");
-                break;
-            }
-
-            boxes_list.clear();
-            if (response["data"].containsKey("boxes")) {
-                JsonArray boxes = response["data"]["boxes"];
-                for (JsonArray box : boxes) {
-                    if (box.size() != 6) {
-                        log_w("Invalid box size...");
-                        continue;
-                    }
-                    BYTETracker::Object cxcywh;
-                    cxcywh.rect.x      = box[0];
-                    cxcywh.rect.y      = box[1];
-                    cxcywh.rect.width  = box[2];
-                    cxcywh.rect.height = box[3];
-                    cxcywh.label       = box[5];
-                    cxcywh.prob        = box[4];
-                    boxes_list.push_back(cxcywh);
-                }
+    // multipart preamble before the first boundary
+    return startStream(req, client, streamFrames, "stream_frame", "\r\n");
+}
 
-                std::vector<STrack> output_stracks = tracker.update(boxes_list);
-
-                boxes.clear();
-                for (STrack& strack : output_stracks) {
-                    JsonDocument doc;
-                    JsonArray    box = doc.to<JsonArray>();
-                    box.add(static_cast<int32_t>(strack.tlwh[0]));
-                    box.add(static_cast<int32_t>(strack.tlwh[1]));
-                    box.add(static_cast<int32_t>(strack.tlwh[2]));
-                    box.add(static_cast<int32_t>(strack.tlwh[3]));
-                    box.add(static_cast<int32_t>(strack.score));
-                    box.add(static_cast<int32_t>(strack.label));
-                    box.add(static_cast<int32_t>(strack.track_id));
-                    boxes.add(box);
-                }
+// tracked result with the base64 image of the raw response put back into its empty "image" value
+static esp_err_t sendTrackedResult(httpd_req_t* req, const PtrBuffer::Slot& slot) {
+    const char* tail  = NULL;
+    const char* value = findImageValue(slot.tracked, slot.tracked_size, NULL, &tail);
+    if (value == NULL) {
+        return httpd_resp_send_chunk(req, slot.tracked, slot.tracked_size);
+    }
 
-            } else if (response["data"].containsKey("keypoints")) {
-                JsonArray keypoints = response["data"]["keypoints"];
-
-                size_t id = 0;
-                for (JsonArray keypoint : keypoints) {
-                    if (keypoint.size() != 2) {
-                        log_w("Invalid keypoint size...");
-                        continue;
-                    }
-                    JsonArray box = keypoint[0];
-                    if (box.size() != 6) {
-                        log_w("Invalid box size...");
-                        continue;
-                    }
-                    BYTETracker::Object cxcywh;
-                    cxcywh.rect.x      = box[0];
-                    cxcywh.rect.y      = box[1];
-                    cxcywh.rect.width  = box[2];
-                    cxcywh.rect.height = box[3];
-                    cxcywh.prob        = box[4];
-                    cxcywh.label       = box[5];
-                    cxcywh.label       = id++ << 16 | (cxcywh.label & 0xffff);
-                    box[5]             = cxcywh.label;
-
-                    boxes_list.push_back(cxcywh);
-                }
+    esp_err_t   res   = httpd_resp_send_chunk(req, slot.tracked, value - slot.tracked);
+    const char* image = findImageValue((const char*)slot.data, slot.size, NULL, &tail);
+    if (image != NULL && tail - 1 > image) {
+        res |= httpd_resp_send_chunk(req, image, tail - 1 - image);
+    }
+    res |= httpd_resp_send_chunk(req, value, slot.tracked + slot.tracked_size - value);
+    return res;
+}
 
-                std::vector<STrack> output_stracks = tracker.update(boxes_list);
-
-                for (JsonArray keypoint : keypoints) {
-                    JsonArray box = keypoint[0];
-                    if (box.size() != 6) {
-                        log_w("Invalid box size...");
-                        continue;
-                    }
-
-                    int  label = box[5];
-                    auto it = std::find_if(output_stracks.begin(), output_stracks.end(), [label](const STrack& strack) {
-                        return strack.label == label;
-                    });
-                    if (it != output_stracks.end()) {
-                        box[0] = static_cast<int32_t>(it->tlwh[0]);
-                        box[1] = static_cast<int32_t>(it->tlwh[1]);
-                        box[2] = static_cast<int32_t>(it->tlwh[2]);
-                        box[3] = static_cast<int32_t>(it->tlwh[3]);
-                        box[4] = static_cast<int32_t>(it->score);
-                        box[5] = static_cast<int32_t>(it->label & 0xffff);
-                        box.add(static_cast<int32_t>(it->track_id));
-
-                        output_stracks.erase(it);
-                    } else {
-                        box[5] = static_cast<int32_t>(label & 0xffff);
-                        box.add(0);
-                    }
-                }
-            }
+static esp_err_t streamResults(httpd_req_t* req, StreamClient* client) {
+    esp_err_t res     = ESP_OK;
+    size_t    last_id = 0;
 
-            size_t len = serializeJson(response, rsp_buf, RSP_BUFFER_SIZE - sizeof(MSG_TERMI_STR));
-            for (size_t i = 0; i < strlen(MSG_TERMI_STR); ++i, ++len) {
-                rsp_buf[len] = MSG_TERMI_STR[i];
-            }
-            rsp_buf[len] = '\0';
-            res          = httpd_resp_send_chunk(req, rsp_buf, len);
+    PtrBuffer::Wakeup wakeup(PB, MSG_TYPE_EVENT);
 
+    // results are tracked at ingestion, every client streams the same bytes
+    while (res == ESP_OK) {
+        if (!streamWritable(req, STREAM_STALL_MS)) {
+            log_w("Stream client stalled, dropping it...");
+            res = ESP_FAIL;
             break;
-#endif
         }
 
-        default:;
+        PtrBuffer::Ref slot = PB.latest(last_id, isFrameSlot);
+        if (!slot) {
+            wakeup.wait(RESULT_TIMEOUT_MS / portTICK_PERIOD_MS);
+            continue;
         }
 
+        if (slot->tracked != NULL) {
+            res |= sendTrackedResult(req, *slot);
+        } else {
+            res |= httpd_resp_send_chunk(req, (const char*)slot->data, slot->size);
+        }
+        res |= httpd_resp_send_chunk(req, MSG_TERMI_STR, strlen(MSG_TERMI_STR));
+
         if (res != ESP_OK) {
             log_e("Send results failed...");
             break;
         }
+
+        client->frames += 1;
     }
 
     return res;
 }
 
+static esp_err_t stream_result_handler(httpd_req_t* req) {
+    esp_err_t res = ESP_OK;
+
+    res |= httpd_resp_set_status(req, HTTPD_200);
+    res |= httpd_resp_set_type(req, "application/json");
+    res |= httpd_resp_set_hdr(req, "Connection", "keep-alive");
+    res |= httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    if (res != ESP_OK) {
+        log_e("Failed to set response headers...");
+        return res;
+    }
+
+    StreamClient* client = acquireStreamClient(httpd_req_to_sockfd(req), true);
+    if (client == NULL) {
+        return rejectStream(req);
+    }
+
+    // whitespace ahead of the first result, still valid json
+    return startStream(req, client, streamResults, "stream_result", " ");
+}
+
 static esp_err_t parse_get(httpd_req_t* req, char** obuf) {
     char*  buf     = NULL;
     size_t buf_len = 0;
@@ -813,48 +1287,43 @@ static esp_err_t command_handler(httpd_req_t* req) {
     char       cmd_tag_buf[32] = {0};
     size_t     cmd_tag_size    = snprintf(cmd_tag_buf, sizeof(cmd_tag_buf), CMD_TAG_FMT_STR, ticks);
 
-    size_t last_id = PB.id;
+    // registered before sending, so a fast reply still wakes us
+    PtrBuffer::Wakeup wakeup(PB, MSG_TYPE_REPLY | MSG_TYPE_LOGGI);
+    size_t            last_id = PB.id - 1;
 
-    AI.write(CMD_PREFIX, strlen(CMD_PREFIX));
-    AI.write(cmd_tag_buf, cmd_tag_size);
-    AI.write(cmd_buf, cmd_size);
+    auto send = [&](SSCMA& ai) {
+        ai.write(CMD_PREFIX, strlen(CMD_PREFIX));
+        ai.write(cmd_tag_buf, cmd_tag_size);
+        ai.write(cmd_buf, cmd_size);
+        ai.write(CMD_SUFFIX, strlen(CMD_SUFFIX));
+        return CMD_OK;
+    };
+    // runs inline when the I/O task is not running
+    int ret = AI.submit(send, CMD_TIMEOUT_MS);
     free(cmd_buf);
-    AI.write(CMD_SUFFIX, strlen(CMD_SUFFIX));
+    if (ret != CMD_OK) {
+        log_w("Failed to send command to the I/O task...");
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
 
-    std::shared_ptr<PtrBuffer::Slot> slot = nullptr;
+    PtrBuffer::Ref slot;
 
     TickType_t time_begin = xTaskGetTickCount();
-    while ((xTaskGetTickCount() - time_begin) < (RESULT_TIMEOUT_MS / portTICK_PERIOD_MS)) {
-        vTaskDelay(5 / portTICK_PERIOD_MS);
-
-        xSemaphoreTake(PB.mutex, portMAX_DELAY);
-        auto slots = PB.slots;
-        xSemaphoreGive(PB.mutex);
-
-        auto it = std::find_if(slots.begin(), slots.end(), [&](std::shared_ptr<PtrBuffer::Slot> p) {
-            if (p->id - last_id <= 0) {
-                return false;
-            }
-
-            if (p->type & MSG_TYPE_REPLY || p->type & MSG_TYPE_LOGGI) {
-                const char* tag = strnstr((const char*)p->data, cmd_tag_buf, p->size);
-                if (tag != NULL) {
-                    return true;
-                }
-            }
-
-            last_id = p->id;
-            return false;
+    TickType_t timeout    = RESULT_TIMEOUT_MS / portTICK_PERIOD_MS;
+    TickType_t elapsed    = 0;
+    while ((elapsed = xTaskGetTickCount() - time_begin) < timeout) {
+        slot = PB.find(last_id, [&](const PtrBuffer::Slot& p) {
+            return (p.type & MSG_TYPE_REPLY || p.type & MSG_TYPE_LOGGI) &&
+                   strnstr((const char*)p.data, cmd_tag_buf, p.size) != NULL;
         });
-        if (it == slots.end()) {
-            continue;
+        if (slot) {
+            break;
         }
-
-        slot = *it;
-        break;
+        wakeup.wait(timeout - elapsed);
     }
 
-    if (slot == nullptr) {
+    if (!slot) {
         log_w("Wait client reply slot timeout...");
         httpd_resp_send_500(req);
         return ESP_OK;
@@ -867,6 +1336,64 @@ static esp_err_t command_handler(httpd_req_t* req) {
     return httpd_resp_send(req, (const char*)slot->data, slot->size);
 }
 
+static esp_err_t stats_handler(httpd_req_t* req) {
+    static const char* names[SLOT_CLASS_COUNT] = {"small", "result", "image"};
+
+    char   buf[1024] = {0};
+    size_t len       = snprintf(buf, sizeof(buf), "{\"pool\": {");
+    for (uint8_t i = 0; i < SLOT_CLASS_COUNT && len < sizeof(buf); ++i) {
+        SlotClassStats st = PB.stats(static_cast<SlotClass>(i));
+        len += snprintf(buf + len,
+                        sizeof(buf) - len,
+                        "%s\"%s\": {\"block_size\": %u, \"blocks\": %u, \"used\": %u, \"pinned\": %u, "
+                        "\"claims\": %u, \"evictions\": %u, \"failures\": %u}",
+                        i ? ", " : "",
+                        names[i],
+                        st.block_size,
+                        st.blocks,
+                        st.used,
+                        st.pinned,
+                        st.claims,
+                        st.evictions,
+                        st.failures);
+    }
+    if (len < sizeof(buf)) {
+        len += snprintf(buf + len, sizeof(buf) - len, "}, \"clients\": [");
+    }
+    bool first = true;
+    for (size_t i = 0; i < STREAM_CLIENTS && len < sizeof(buf); ++i) {
+        int fd = SC[i].fd.load();
+        if (fd < 0) {
+            continue;
+        }
+        uint32_t fps_x100 = SC[i].fps_x100.load();
+        len += snprintf(buf + len,
+                        sizeof(buf) - len,
+                        "%s{\"fd\": %d, \"stream\": \"%s\", \"fps\": %u.%02u, \"fps_limit\": %u, \"kbps_limit\": %u, "
+                        "\"frames\": %u, \"dropped\": %u, \"bytes\": %u}",
+                        first ? "" : ", ",
+                        fd,
+                        SC[i].results.load() ? "result" : "frame",
+                        fps_x100 / 100,
+                        fps_x100 % 100,
+                        SC[i].fps_limit.load(),
+                        SC[i].kbps_limit.load(),
+                        SC[i].frames.load(),
+                        SC[i].dropped.load(),
+                        SC[i].bytes.load());
+        first = false;
+    }
+    if (len < sizeof(buf)) {
+        len += snprintf(buf + len, sizeof(buf) - len, "]}");
+    }
+    len = std::min(len, sizeof(buf) - 1);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+
+    return httpd_resp_send(req, buf, len);
+}
+
 static esp_err_t index_handler(httpd_req_t* req) {
     httpd_resp_set_type(req, "text/html");
     httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
@@ -891,6 +1418,18 @@ void startCameraServer() {
 #endif
     };
 
+    httpd_uri_t stats_uri = {.uri      = "/stats",
+                             .method   = HTTP_GET,
+                             .handler  = stats_handler,
+                             .user_ctx = NULL
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+                             ,
+                             .is_websocket             = true,
+                             .handle_ws_control_frames = false,
+                             .supported_subprotocol    = NULL
+#endif
+    };
+
     httpd_uri_t command_uri = {.uri      = "/command",
                                .method   = HTTP_GET,
                                .handler  = command_handler,
@@ -948,6 +1487,7 @@ void startCameraServer() {
         ret |= httpd_register_uri_handler(web_httpd, &index_uri);
         ret |= httpd_register_uri_handler(web_httpd, &result_uri);
         ret |= httpd_register_uri_handler(web_httpd, &command_uri);
+        ret |= httpd_register_uri_handler(web_httpd, &stats_uri);
     }
 
     if (ret != ESP_OK) {
@@ -0,0 +1,44 @@
+#include <Seeed_Arduino_SSCMA.h>
+
+SSCMA AI;
+
+uint32_t last_report = 0;
+
+void setup()
+{
+    AI.begin();
+    Serial.begin(9600);
+}
+
+void loop()
+{
+    // the next frame is already being inferred while we print this one
+    if (!AI.invoke_pipelined())
+    {
+        for (int i = 0; i < AI.boxes().size(); i++)
+        {
+            Serial.print("Box[");
+            Serial.print(i);
+            Serial.print("] target=");
+            Serial.print(AI.boxes()[i].target);
+            Serial.print(", score=");
+            Serial.print(AI.boxes()[i].score);
+            Serial.print(", x=");
+            Serial.print(AI.boxes()[i].x);
+            Serial.print(", y=");
+            Serial.println(AI.boxes()[i].y);
+        }
+    }
+
+    if (millis() - last_report > 5000)
+    {
+        invoke_stats_t stats = AI.invoke_stats();
+        Serial.print("fps=");
+        Serial.print(stats.fps);
+        Serial.print(", device idle=");
+        Serial.print(stats.idle_ratio * 100);
+        Serial.println("%");
+        AI.invoke_stats_reset();
+        last_report = millis();
+    }
+}
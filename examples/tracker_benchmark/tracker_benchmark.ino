@@ -0,0 +1,97 @@
+// Times the tracker on a simulated scene, no device needed: objects bounce around a 480x360 frame, flicker in
+// and out and are missed now and then, and the detections are fed to BYTETracker like SSCMAByteTracker does.
+#include <Seeed_Arduino_SSCMA.h>
+#include <tracker/BYTETracker.h>
+
+#define OBJECTS 25
+#define FRAMES  500
+
+struct object_t
+{
+    float x, y, vx, vy, w, h;
+    int target;
+    bool alive;
+};
+
+static uint32_t seed = 1;
+
+static float frand()
+{
+    seed = seed * 1103515245u + 12345u;
+    return ((seed >> 8) & 0xffff) / 65536.0f;
+}
+
+void setup()
+{
+    Serial.begin(115200);
+}
+
+void loop()
+{
+    object_t objects[OBJECTS];
+    for (int i = 0; i < OBJECTS; i++)
+    {
+        objects[i].x = frand() * 400 + 20;
+        objects[i].y = frand() * 300 + 20;
+        objects[i].vx = (frand() - 0.5f) * 8;
+        objects[i].vy = (frand() - 0.5f) * 8;
+        objects[i].w = 20 + frand() * 60;
+        objects[i].h = 20 + frand() * 80;
+        objects[i].target = frand() * 3;
+        objects[i].alive = true;
+    }
+
+    BYTETracker tracker;
+    std::vector<BYTETracker::Object> detections;
+    uint32_t elapsed = 0;
+    uint32_t tracked = 0;
+    for (int f = 0; f < FRAMES; f++)
+    {
+        detections.clear();
+        for (int i = 0; i < OBJECTS; i++)
+        {
+            object_t &o = objects[i];
+            o.x += o.vx;
+            o.y += o.vy;
+            if (o.x < 0 || o.x > 480)
+            {
+                o.vx = -o.vx;
+            }
+            if (o.y < 0 || o.y > 360)
+            {
+                o.vy = -o.vy;
+            }
+            if (frand() < 0.02f)
+            {
+                o.alive = !o.alive;
+            }
+            if (!o.alive || frand() < 0.1f)
+            {
+                continue;
+            }
+            BYTETracker::Object d;
+            d.rect.x = o.x + (frand() - 0.5f) * 3;
+            d.rect.y = o.y + (frand() - 0.5f) * 3;
+            d.rect.width = o.w + (frand() - 0.5f) * 2;
+            d.rect.height = o.h + (frand() - 0.5f) * 2;
+            d.label = o.target;
+            d.prob = 0.3f + frand() * 0.7f;
+            detections.push_back(d);
+        }
+
+        uint32_t start = micros();
+        tracked += tracker.update(detections).size();
+        elapsed += micros() - start;
+    }
+
+    Serial.print(BYTE_TRACKER_FIXED_POINT ? "Q16.16" : "float");
+    Serial.print(" tracker, ");
+    Serial.print(OBJECTS);
+    Serial.print(" objects: ");
+    Serial.print((float)elapsed / FRAMES);
+    Serial.print(" us/frame, ");
+    Serial.print(tracked / FRAMES);
+    Serial.println(" tracks/frame");
+
+    delay(1000);
+}
@@ -0,0 +1,47 @@
+#include <Seeed_Arduino_SSCMA.h>
+
+SSCMA AI;
+SSCMAByteTracker tracker;
+
+void setup()
+{
+    AI.begin();
+    AI.set_tracker(&tracker);
+    Serial.begin(9600);
+}
+
+void loop()
+{
+    if (!AI.invoke())
+    {
+        // a box keeps its track id from frame to frame, 0 until its track is confirmed
+        for (int i = 0; i < AI.boxes().size(); i++)
+        {
+            Serial.print("Box[");
+            Serial.print(i);
+            Serial.print("] track=");
+            Serial.print(AI.boxes()[i].track_id);
+            Serial.print(", target=");
+            Serial.print(AI.boxes()[i].target);
+            Serial.print(", score=");
+            Serial.print(AI.boxes()[i].score);
+            Serial.print(", x=");
+            Serial.print(AI.boxes()[i].x);
+            Serial.print(", y=");
+            Serial.println(AI.boxes()[i].y);
+        }
+        for (int i = 0; i < AI.keypoints().size(); i++)
+        {
+            Serial.print("keypoint[");
+            Serial.print(i);
+            Serial.print("] track=");
+            Serial.print(AI.keypoints()[i].box.track_id);
+            Serial.print(", target=");
+            Serial.print(AI.keypoints()[i].box.target);
+            Serial.print(", x=");
+            Serial.print(AI.keypoints()[i].box.x);
+            Serial.print(", y=");
+            Serial.println(AI.keypoints()[i].box.y);
+        }
+    }
+}
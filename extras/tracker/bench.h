@@ -0,0 +1,21 @@
+// Timing helper shared by the host benchmarks.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+// mean time of one call to body in microseconds, the best of five runs of iterations calls each
+template <typename F>
+static double best_us(int iterations, F&& body) {
+    double best = 1e30;
+    for (int run = 0; run < 5; run++) {
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            body();
+        }
+        auto end = std::chrono::steady_clock::now();
+        best     = std::min(best, std::chrono::duration<double, std::micro>(end - begin).count() / iterations);
+    }
+    return best;
+}
@@ -0,0 +1,40 @@
+// Host microbenchmark of the packed Kalman filter in src/tracker against the Eigen filter it replaced
+// (reference/kalmanFilterEigen.cpp): predict and update per track, and how far the two drift apart.
+
+#include <cstdio>
+
+#include "bench.h"
+#include "kalman_compare.h"
+
+using namespace std;
+
+static void compare(int n, int steps) {
+    KalmanDrift drift = kalman_drift(n, steps);
+    printf("%d tracks, %d predict/update steps: %ld of %ld values differ\n", n, steps, drift.differing, drift.values);
+    printf("worst mean error %.3g, worst relative covariance error %.3g\n\n", drift.worst_mean, drift.worst_cov);
+}
+
+static volatile float sink;
+
+int main() {
+    compare(32, 300);
+
+    printf("per track and call\n");
+    printf("%7s %14s %14s %14s %14s\n", "tracks", "predict eigen", "predict packed", "update eigen", "update packed");
+    for (int n : {1, 8, 32, 64}) {
+        int     iterations = 20000 / n + 10;
+        Filters f(n, n);
+        double  predict_eigen  = best_us(iterations, [&] { f.predict_eigen(); }) / n;
+        double  predict_packed = best_us(iterations, [&] { f.predict_packed(); }) / n;
+        double  update_eigen   = best_us(iterations, [&] { f.update_eigen(); }) / n;
+        double  update_packed  = best_us(iterations, [&] { f.update_packed(); }) / n;
+        sink                   = f.eigen_states[0].first(0) + static_cast<float>(f.states.mean(0)[0]);
+        printf("%7d %11.1f ns %11.1f ns %11.1f ns %11.1f ns\n",
+               n,
+               predict_eigen * 1000,
+               predict_packed * 1000,
+               update_eigen * 1000,
+               update_packed * 1000);
+    }
+    return 0;
+}
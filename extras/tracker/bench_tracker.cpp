@@ -0,0 +1,196 @@
+// Host benchmark of the tracker stages: the IoU cost matrix against the nested vector version the tracker
+// used to build, LapJV, and a whole update() per frame. Inputs are seeded, each timing is the best of a few runs.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "BYTETracker.h"
+#include "bench.h"
+#include "scene.h"
+
+using namespace std;
+
+struct BYTETrackerBench {
+    static const vector<track_real_t>& iou_distance(BYTETracker&           tracker,
+                                                    const vector<STrack*>& atracks,
+                                                    const vector<STrack*>& btracks) {
+        int rows, cols;
+        tracker.iou_distance(atracks, btracks, rows, cols);
+        return tracker.dists;
+    }
+
+    static size_t linear_assignment(BYTETracker& tracker, const track_real_t* cost, int rows, int cols) {
+        tracker.matches.clear();
+        tracker.u_track.clear();
+        tracker.u_detection.clear();
+        tracker.linear_assignment(
+          cost, rows, cols, tracker.match_thresh, tracker.matches, tracker.u_track, tracker.u_detection);
+        return tracker.matches.size();
+    }
+};
+
+// ious() and the cost matrix build as they were before the flat kernel
+static vector<vector<float> > reference_ious(vector<vector<float> >& atlbrs, vector<vector<float> >& btlbrs) {
+    vector<vector<float> > ious;
+    if (atlbrs.size() * btlbrs.size() == 0) return ious;
+
+    ious.resize(atlbrs.size());
+    for (size_t i = 0; i < ious.size(); i++) {
+        ious[i].resize(btlbrs.size());
+    }
+
+    for (size_t k = 0; k < btlbrs.size(); k++) {
+        float box_area = (btlbrs[k][2] - btlbrs[k][0] + 1) * (btlbrs[k][3] - btlbrs[k][1] + 1);
+        for (size_t n = 0; n < atlbrs.size(); n++) {
+            float iw = min(atlbrs[n][2], btlbrs[k][2]) - max(atlbrs[n][0], btlbrs[k][0]) + 1;
+            if (iw > 0) {
+                float ih = min(atlbrs[n][3], btlbrs[k][3]) - max(atlbrs[n][1], btlbrs[k][1]) + 1;
+                if (ih > 0) {
+                    float ua =
+                      (atlbrs[n][2] - atlbrs[n][0] + 1) * (atlbrs[n][3] - atlbrs[n][1] + 1) + box_area - iw * ih;
+                    ious[n][k] = iw * ih / ua;
+                } else {
+                    ious[n][k] = 0.0;
+                }
+            } else {
+                ious[n][k] = 0.0;
+            }
+        }
+    }
+
+    return ious;
+}
+
+static vector<vector<float> > reference_iou_distance(const vector<vector<float> >& a, const vector<vector<float> >& b) {
+    vector<vector<float> > atlbrs = a, btlbrs = b;
+    vector<vector<float> > _ious{reference_ious(atlbrs, btlbrs)};
+    vector<vector<float> > cost_matrix(_ious.size());
+    for (size_t i = 0; i < _ious.size(); i++) {
+        vector<float> _iou(_ious[i].size());
+        for (size_t j = 0; j < _iou.size(); j++) {
+            _iou[j] = 1 - _ious[i][j];
+        }
+        cost_matrix[i] = _iou;
+    }
+    return cost_matrix;
+}
+
+static volatile float sink;
+
+// n tracks and n detections a few pixels off them, every label the same so the whole matrix is one problem
+static void make_boxes(int n, uint32_t seed, vector<STrack>& a, vector<STrack>& b) {
+    Scene scene(seed, 0);
+    a.resize(n);
+    b.resize(n);
+    for (int i = 0; i < n; i++) {
+        float x = scene.uniform() * 640, y = scene.uniform() * 480;
+        float w = 20 + scene.uniform() * 40, h = 20 + scene.uniform() * 40;
+        float d = (scene.uniform() - 0.5f) * 4;
+        float ta[4] = {x, y, x + w, y + h};
+        float tb[4] = {x + d, y + d, x + w + d, y + h};
+        for (int k = 0; k < 4; k++) {
+            a[i].tlbr[k] = ta[k];
+            b[i].tlbr[k] = tb[k];
+        }
+        a[i].label = b[i].label = 0;
+    }
+}
+
+static void bench_iou() {
+    printf("iou cost matrix, n tracks x n detections, per call\n");
+    printf("%9s %12s %12s %10s\n", "n", "reference", "kernel", "mismatch");
+    for (int n : {10, 25, 50, 100, 200}) {
+        vector<STrack>  a, b;
+        vector<STrack*> pa, pb;
+        make_boxes(n, n, a, b);
+        vector<vector<float> > fa(n, vector<float>(4)), fb(n, vector<float>(4));
+        for (int i = 0; i < n; i++) {
+            pa.push_back(&a[i]);
+            pb.push_back(&b[i]);
+            for (int k = 0; k < 4; k++) {
+                fa[i][k] = static_cast<float>(a[i].tlbr[k]);
+                fb[i][k] = static_cast<float>(b[i].tlbr[k]);
+            }
+        }
+
+        BYTETracker                  tracker;
+        const vector<track_real_t>&  dists    = BYTETrackerBench::iou_distance(tracker, pa, pb);
+        const vector<vector<float> > ref      = reference_iou_distance(fa, fb);
+        int                          mismatch = 0;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                float got = static_cast<float>(dists[i * n + j]);
+                mismatch += memcmp(&got, &ref[i][j], sizeof(float)) != 0;
+            }
+        }
+
+        int    iterations = 2000000 / (n * n) + 10;
+        double ref_us     = best_us(iterations, [&] { sink = reference_iou_distance(fa, fb)[0][0]; });
+        double new_us     = best_us(iterations, [&] {
+            sink = static_cast<float>(BYTETrackerBench::iou_distance(tracker, pa, pb)[0]);
+        });
+        printf("%4dx%-4d %9.2f us %9.2f us %10d\n", n, n, ref_us, new_us, mismatch);
+    }
+}
+
+static void bench_assignment() {
+    printf("\nassignment on the iou costs, per call\n");
+    printf("%9s %12s %18s %8s\n", "n", "LapJV", "linear_assignment", "matches");
+    for (int n : {10, 25, 50, 100, 200}) {
+        vector<STrack>  a, b;
+        vector<STrack*> pa, pb;
+        make_boxes(n, n, a, b);
+        for (int i = 0; i < n; i++) {
+            pa.push_back(&a[i]);
+            pb.push_back(&b[i]);
+        }
+
+        BYTETracker          tracker;
+        vector<track_real_t> cost = BYTETrackerBench::iou_distance(tracker, pa, pb);
+        LapJV                lap;
+        vector<int>          x(n), y(n);
+        size_t               matches = 0;
+
+        int    iterations = 200000 / n + 10;
+        double lap_us     = best_us(iterations, [&] { lap.solve(cost.data(), n, n, x.data(), y.data()); });
+        double assign_us  = best_us(iterations, [&] {
+            matches = BYTETrackerBench::linear_assignment(tracker, cost.data(), n, n);
+        });
+        printf("%4dx%-4d %9.2f us %15.2f us %8zu\n", n, n, lap_us, assign_us, matches);
+    }
+}
+
+static void bench_update() {
+    const int frames = 500;
+    printf("\nupdate(), %d frames of a seeded scene, per frame\n", frames);
+    printf("%9s %12s\n", "objects", "update");
+    for (int objects : {10, 30, 60}) {
+        double best = 1e30;
+        for (int run = 0; run < 5; run++) {
+            Scene                       scene(1, objects);
+            BYTETracker                 tracker;
+            vector<BYTETracker::Object> detections;
+            vector<int>                 visible;
+            double                      us = 0;
+            for (int f = 0; f < frames; f++) {
+                scene.step(detections, visible);
+                auto begin = chrono::steady_clock::now();
+                sink       = tracker.update(detections).size();
+                us += chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count();
+            }
+            best = min(best, us / frames);
+        }
+        printf("%9d %9.2f us\n", objects, best);
+    }
+}
+
+int main() {
+    printf("%s\n\n", TRACKER_VARIANT);
+    bench_iou();
+    bench_assignment();
+    bench_update();
+    return 0;
+}
@@ -0,0 +1,85 @@
+// Holds the Q16.16 tracker against the float one on the same seeded scene: both track_scene builds are run
+// and their outputs compared. An object counts as agreeing on a frame when both or neither track it, and its
+// ids agree when the q16 id is the one that float id has always been paired with. Fails below the thresholds:
+// objects blink out, and one picked up again a frame apart keeps its differing ids for the rest of its life, so
+// ids agree a little less often than tracks do.
+//
+//   compare_tracker <track_scene> <track_scene_q16>
+
+#include <cstdio>
+#include <map>
+#include <utility>
+
+using namespace std;
+
+struct Run {
+    map<pair<int, int>, int> ids;  // (frame, object) -> track id
+    long                     matched  = 0;
+    long                     switches = 0;
+    double                   us       = 0;
+};
+
+static bool run(const char* path, Run& r) {
+    FILE* out = popen(path, "r");
+    if (!out) return false;
+    map<int, int> last;  // object -> track id
+    char          line[64];
+    int           frame, object, id;
+    bool          done = false;
+    while (fgets(line, sizeof(line), out)) {
+        if (sscanf(line, "time %lf", &r.us) == 1) {
+            done = true;
+        } else if (sscanf(line, "%d %d %d", &frame, &object, &id) == 3) {
+            r.ids[{frame, object}] = id;
+            auto it                = last.find(object);
+            if (it != last.end() && it->second != id) r.switches += 1;
+            last[object] = id;
+            r.matched += 1;
+        }
+    }
+    return pclose(out) == 0 && done;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <track_scene> <track_scene_q16>\n", argv[0]);
+        return 2;
+    }
+    Run f, q;
+    if (!run(argv[1], f) || !run(argv[2], q)) {
+        fprintf(stderr, "track_scene failed\n");
+        return 2;
+    }
+
+    long          both = 0, only = 0, same_id = 0;
+    map<int, int> to_q16, to_float;
+    for (const auto& kv : f.ids) {
+        auto it = q.ids.find(kv.first);
+        if (it == q.ids.end()) {
+            only += 1;
+            continue;
+        }
+        both += 1;
+        auto fq = to_q16.emplace(kv.second, it->second).first;
+        auto qf = to_float.emplace(it->second, kv.second).first;
+        same_id += fq->second == it->second && qf->second == kv.second;
+    }
+    only += static_cast<long>(q.ids.size()) - both;
+
+    double tracked  = 100.0 * both / (both + only);
+    double ids      = 100.0 * same_id / both;
+    double matched  = 100.0 * (q.matched - f.matched) / f.matched;
+    long   switches = q.switches - f.switches;
+    printf("%10s %10s %10s %10s\n", "", "matched", "switches", "fps");
+    printf("%10s %10ld %10ld %10.0f\n", "float", f.matched, f.switches, 1e6 / f.us);
+    printf("%10s %10ld %10ld %10.0f\n", "q16", q.matched, q.switches, 1e6 / q.us);
+    printf("tracked by both %.2f%%, same ids %.2f%%, matched %+.2f%%, switches %+ld\n",
+           tracked,
+           ids,
+           matched,
+           switches);
+
+    bool ok = tracked >= 99.5 && ids >= 97 && matched > -0.5 && matched < 0.5 && switches >= -5 && switches <= 5;
+    if (!ok) printf("FAILED: needs tracked >= 99.5%%, same ids >= 97%%, matched within 0.5%%, switches within 5\n");
+    return ok ? 0 : 1;
+}
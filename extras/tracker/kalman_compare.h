@@ -0,0 +1,131 @@
+// The packed Kalman filter in src/tracker and the Eigen filter it replaced (reference/kalmanFilterEigen.cpp)
+// side by side on the same seeded boxes, shared by bench_kalman and test_tracker.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "kalmanFilter.h"
+#include "kalmanFilterEigen.h"
+#include "scene.h"
+
+// x, y, a, h of a box near the middle of a 640x480 frame, jittered by a few pixels
+static void measure(Scene& scene, float measurement[4]) {
+    measurement[0] = 320 + (scene.uniform() - 0.5f) * 200;
+    measurement[1] = 240 + (scene.uniform() - 0.5f) * 200;
+    measurement[2] = 0.5f + scene.uniform();
+    measurement[3] = 40 + scene.uniform() * 60;
+}
+
+struct Filters {
+    byte_kalman::KalmanFilter                 packed;
+    byte_kalman::KalmanStates                 states;
+    ref_kalman::KalmanFilter                  eigen;
+    std::vector<ref_kalman::KAL_DATA>         eigen_states;
+    std::vector<ref_kalman::DETECTBOX>        eigen_measurements;
+    std::vector<std::array<track_real_t, 4> > measurements;
+
+    Filters(int n, uint32_t seed) : eigen_states(n), eigen_measurements(n), measurements(n) {
+        Scene scene(seed, 0);
+        states.resize(n);
+        for (int t = 0; t < n; t++) {
+            float m[4];
+            measure(scene, m);
+            for (int k = 0; k < 4; k++) {
+                measurements[t][k]       = m[k];
+                eigen_measurements[t][k] = m[k];
+            }
+            packed.initiate(measurements[t].data(), states.mean(t), states.covariance(t), states.stride());
+            eigen_states[t] = eigen.initiate(eigen_measurements[t]);
+            states.mask[t]  = KAL_PREDICT;
+        }
+    }
+
+    void predict_packed() { packed.multi_predict(states); }
+
+    // KAL_PREDICT resets the h velocity first, as multi_predict() does for tracks not in the Tracked state
+    void predict_eigen() {
+        for (ref_kalman::KAL_DATA& d : eigen_states) {
+            d.first(7) = 0;
+            eigen.predict(d.first, d.second);
+        }
+    }
+
+    void update_packed() {
+        for (int t = 0; t < states.size(); t++) {
+            packed.update(states.mean(t), states.covariance(t), states.stride(), measurements[t].data());
+        }
+    }
+
+    void update_eigen() {
+        for (size_t t = 0; t < eigen_states.size(); t++) {
+            eigen_states[t] = eigen.update(eigen_states[t].first, eigen_states[t].second, eigen_measurements[t]);
+        }
+    }
+};
+
+struct KalmanDrift {
+    long   values     = 0;
+    long   differing  = 0;
+    double worst_mean = 0;  // absolute, in pixels for the positions
+    double worst_cov  = 0;  // relative to the Eigen value
+};
+
+// replays predict/update steps on both filters and compares every mean and covariance term; velocities hover
+// around 0, so the mean is compared in absolute terms and the covariance relative to its value
+static KalmanDrift kalman_drift(int n, int steps) {
+    Filters     f(n, 7);
+    Scene       scene(11, 0);
+    KalmanDrift drift;
+    for (int step = 0; step < steps; step++) {
+        f.predict_packed();
+        f.predict_eigen();
+        // the boxes wander a little every step
+        for (int t = 0; t < n; t++) {
+            for (int k = 0; k < 4; k++) {
+                float step                 = k == 2 ? 0.02f : 4;
+                float m                    = f.eigen_measurements[t][k] + (scene.uniform() - 0.5f) * step;
+                f.measurements[t][k]       = m;
+                f.eigen_measurements[t][k] = m;
+            }
+        }
+        f.update_packed();
+        f.update_eigen();
+
+        const int stride = f.states.stride();
+        for (int t = 0; t < n; t++) {
+            const track_real_t*         mean = f.states.mean(t);
+            const track_real_t*         cov  = f.states.covariance(t);
+            const ref_kalman::KAL_DATA& ref  = f.eigen_states[t];
+            float                       got[20], want[20];
+            for (int k = 0; k < 8; k++) {
+                got[k]  = static_cast<float>(mean[k * stride]);
+                want[k] = ref.first(k);
+            }
+            for (int i = 0; i < 4; i++) {
+                got[8 + i]   = static_cast<float>(cov[(KAL_PP + i) * stride]);
+                got[12 + i]  = static_cast<float>(cov[(KAL_PV + i) * stride]);
+                got[16 + i]  = static_cast<float>(cov[(KAL_VV + i) * stride]);
+                want[8 + i]  = ref.second(i, i);
+                want[12 + i] = ref.second(i, i + 4);
+                want[16 + i] = ref.second(i + 4, i + 4);
+            }
+            for (int k = 0; k < 20; k++) {
+                drift.values += 1;
+                if (memcmp(&got[k], &want[k], sizeof(float)) == 0) continue;
+                drift.differing += 1;
+                double error = std::fabs((double)got[k] - want[k]);
+                if (k < 8) {
+                    drift.worst_mean = std::max(drift.worst_mean, error);
+                } else {
+                    drift.worst_cov = std::max(drift.worst_cov, error / std::fabs((double)want[k]));
+                }
+            }
+        }
+    }
+    return drift;
+}
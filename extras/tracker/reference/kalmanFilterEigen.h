@@ -1,31 +1,45 @@
-/*
- * MIT License
- * Copyright (c) 2021 Yifu Zhang
- *
- * Modified by nullptr, Apr 15, 2024, Seeed Technology Co.,Ltd
-*/
-
-#pragma once
-
-#include "dataType.h"
-
-namespace byte_kalman {
-class KalmanFilter {
-   public:
-    static const double chi2inv95[10];
-
-    KalmanFilter();
-
-    KAL_DATA  initiate(const DETECTBOX& measurement);
-    void      predict(KAL_MEAN& mean, KAL_COVA& covariance);
-    KAL_HDATA project(const KAL_MEAN& mean, const KAL_COVA& covariance);
-    KAL_DATA  update(const KAL_MEAN& mean, const KAL_COVA& covariance, const DETECTBOX& measurement);
-
-   private:
-    Eigen::Matrix<float, 8, 8, Eigen::RowMajor> _motion_mat;
-    Eigen::Matrix<float, 4, 8, Eigen::RowMajor> _update_mat;
-
-    float _std_weight_position;
-    float _std_weight_velocity;
-};
-}  // namespace byte_kalman
\ No newline at end of file
+/*
+ * MIT License
+ * Copyright (c) 2021 Yifu Zhang
+ *
+ * Modified by nullptr, Apr 15, 2024, Seeed Technology Co.,Ltd
+*/
+
+// The Eigen Kalman filter the tracker used before the packed one in src/tracker, kept as the reference for
+// bench_kalman. Only the namespace and the Eigen include differ from the original.
+
+#pragma once
+
+#include <utility>
+
+#include <Eigen/Dense>
+
+namespace ref_kalman {
+
+typedef Eigen::Matrix<float, 1, 4, Eigen::RowMajor> DETECTBOX;
+typedef Eigen::Matrix<float, 1, 8, Eigen::RowMajor> KAL_MEAN;
+typedef Eigen::Matrix<float, 8, 8, Eigen::RowMajor> KAL_COVA;
+typedef Eigen::Matrix<float, 1, 4, Eigen::RowMajor> KAL_HMEAN;
+typedef Eigen::Matrix<float, 4, 4, Eigen::RowMajor> KAL_HCOVA;
+using KAL_DATA  = std::pair<KAL_MEAN, KAL_COVA>;
+using KAL_HDATA = std::pair<KAL_HMEAN, KAL_HCOVA>;
+
+class KalmanFilter {
+   public:
+    static const double chi2inv95[10];
+
+    KalmanFilter();
+
+    KAL_DATA  initiate(const DETECTBOX& measurement);
+    void      predict(KAL_MEAN& mean, KAL_COVA& covariance);
+    KAL_HDATA project(const KAL_MEAN& mean, const KAL_COVA& covariance);
+    KAL_DATA  update(const KAL_MEAN& mean, const KAL_COVA& covariance, const DETECTBOX& measurement);
+
+   private:
+    Eigen::Matrix<float, 8, 8, Eigen::RowMajor> _motion_mat;
+    Eigen::Matrix<float, 4, 8, Eigen::RowMajor> _update_mat;
+
+    float _std_weight_position;
+    float _std_weight_velocity;
+};
+}  // namespace ref_kalman
@@ -0,0 +1,72 @@
+// Seeded synthetic detections for the host benchmarks and tests: boxes moving at constant velocity that
+// bounce off the frame edges, blink out now and then, and are detected with some jitter and misses.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "BYTETracker.h"
+
+struct SceneObject {
+    float x, y, vx, vy, w, h;
+    int   label;
+    bool  alive;
+};
+
+class Scene {
+   public:
+    Scene(uint32_t seed, int objects, int labels = 3) : _rng(seed), _objects(objects) {
+        for (SceneObject& o : _objects) {
+            o.x     = uniform() * 400 + 20;
+            o.y     = uniform() * 300 + 20;
+            o.vx    = (uniform() - 0.5f) * 8;
+            o.vy    = (uniform() - 0.5f) * 8;
+            o.w     = 20 + uniform() * 60;
+            o.h     = 20 + uniform() * 80;
+            o.label = static_cast<int>(uniform() * labels);
+            o.alive = true;
+        }
+    }
+
+    // moves every object one frame and fills detections, visible[i] is the object behind detections[i]
+    void step(std::vector<BYTETracker::Object>& detections, std::vector<int>& visible) {
+        detections.clear();
+        visible.clear();
+        for (size_t i = 0; i < _objects.size(); i++) {
+            SceneObject& o = _objects[i];
+            o.x += o.vx;
+            o.y += o.vy;
+            if (o.x < 0 || o.x > 480) o.vx = -o.vx;
+            if (o.y < 0 || o.y > 360) o.vy = -o.vy;
+            if (uniform() < blink) o.alive = !o.alive;
+            if (!o.alive || uniform() < miss) continue;
+
+            BYTETracker::Object d;
+            d.rect.x      = o.x + (uniform() - 0.5f) * jitter;
+            d.rect.y      = o.y + (uniform() - 0.5f) * jitter;
+            d.rect.width  = o.w + (uniform() - 0.5f) * 2;
+            d.rect.height = o.h + (uniform() - 0.5f) * 2;
+            d.label       = o.label;
+            d.prob        = 0.3f + uniform() * 0.7f;
+            detections.push_back(d);
+            visible.push_back(i);
+        }
+    }
+
+    const std::vector<SceneObject>& objects() const { return _objects; }
+
+    // [0, 1), a fixed LCG so every platform replays the same scene
+    float uniform() {
+        _rng = _rng * 1103515245u + 12345u;
+        return ((_rng >> 8) & 0xffff) / 65536.0f;
+    }
+
+    float blink  = 0.02f;  // chance per frame that an object appears or disappears
+    float miss   = 0.1f;   // chance that a visible object is not detected
+    float jitter = 3.f;    // pixels of noise on the detected position
+
+   private:
+    uint32_t                 _rng;
+    std::vector<SceneObject> _objects;
+};
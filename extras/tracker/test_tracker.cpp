@@ -0,0 +1,259 @@
+// Host tests of the tracker in src/tracker: track ids stay put while objects are followed, survive short
+// occlusions and never jump across labels, and LapJV finds optimal assignments. Run by ctest, a failed CHECK
+// ends its case and makes the run exit non-zero.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "BYTETracker.h"
+#include "scene.h"
+#ifdef TRACKER_EIGEN_REFERENCE
+#include "kalman_compare.h"
+#endif
+
+using namespace std;
+
+static int failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            printf("  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            failures += 1;                                                    \
+            return;                                                           \
+        }                                                                     \
+    } while (0)
+
+static BYTETracker::Object box(float x, float y, float w, float h, int label, float prob = 0.9f) {
+    BYTETracker::Object o;
+    o.rect.x      = x;
+    o.rect.y      = y;
+    o.rect.width  = w;
+    o.rect.height = h;
+    o.label       = label;
+    o.prob        = prob;
+    return o;
+}
+
+// track id of every output track by the object it was matched with
+static map<int, int> ids_by_object(const vector<STrack>& tracks) {
+    map<int, int> ids;
+    for (const STrack& t : tracks) {
+        ids[t.object] = t.track_id;
+    }
+    return ids;
+}
+
+static void test_still_object() {
+    BYTETracker tracker;
+    int         id = 0;
+    for (int f = 0; f < 50; f++) {
+        const vector<STrack>& out = tracker.update({box(100, 100, 40, 60, 0)});
+        if (f == 0) continue;  // a track is confirmed on its second frame
+        CHECK(out.size() == 1);
+        CHECK(out[0].track_id > 0);
+        CHECK(out[0].object == 0);
+        CHECK(id == 0 || out[0].track_id == id);
+        id = out[0].track_id;
+    }
+}
+
+// objects on parallel lanes, detected every frame, in shuffled order
+static void test_moving_objects() {
+    const int   objects = 8;
+    BYTETracker tracker;
+    vector<int> ids(objects, 0);
+    Scene       order(3, 0);
+    for (int f = 0; f < 200; f++) {
+        vector<int> perm(objects);
+        for (int i = 0; i < objects; i++) perm[i] = i;
+        for (int i = objects - 1; i > 0; i--) swap(perm[i], perm[static_cast<int>(order.uniform() * (i + 1))]);
+
+        vector<BYTETracker::Object> detections;
+        for (int i : perm) {
+            detections.push_back(box(10 + f * 2.f, 10 + i * 55.f, 30, 40, i % 2));
+        }
+        map<int, int> seen = ids_by_object(tracker.update(detections));
+        if (f == 0) continue;
+        CHECK(static_cast<int>(seen.size()) == objects);
+        for (const auto& kv : seen) {
+            int i = perm[kv.first];
+            CHECK(ids[i] == 0 || ids[i] == kv.second);
+            ids[i] = kv.second;
+        }
+    }
+    CHECK(set<int>(ids.begin(), ids.end()).size() == objects);
+}
+
+// an object missing for a few frames is picked up by its old track
+static void test_occlusion() {
+    BYTETracker tracker;
+    int         id = 0;
+    for (int f = 0; f < 60; f++) {
+        vector<BYTETracker::Object> detections;
+        bool                        hidden = f >= 20 && f < 28;
+        if (!hidden) detections.push_back(box(50 + f * 3.f, 200, 40, 60, 0));
+        const vector<STrack>& out = tracker.update(detections);
+        if (f == 0) continue;
+        if (hidden) {
+            CHECK(out.empty());
+            continue;
+        }
+        CHECK(out.size() == 1);
+        CHECK(id == 0 || out[0].track_id == id);
+        id = out[0].track_id;
+    }
+}
+
+// two objects of different labels cross each other; their tracks keep their ids and labels
+static void test_crossing_labels() {
+    BYTETracker tracker;
+    int         ids[2] = {0, 0};
+    for (int f = 0; f < 60; f++) {
+        vector<BYTETracker::Object> detections = {box(100 + f * 4.f, 200, 40, 60, 1),
+                                                  box(340 - f * 4.f, 202, 40, 60, 2)};
+        const vector<STrack>&       out        = tracker.update(detections);
+        if (f == 0) continue;
+        for (const STrack& t : out) {
+            CHECK(t.label == detections[t.object].label);
+            CHECK(ids[t.object] == 0 || ids[t.object] == t.track_id);
+            ids[t.object] = t.track_id;
+        }
+    }
+    CHECK(ids[0] != 0 && ids[1] != 0 && ids[0] != ids[1]);
+}
+
+// a seeded scene with jitter and missed detections: few id switches among the matched objects. Objects do
+// not vanish for good here, one gone longer than the track buffer rightly comes back under a new id.
+static void test_scene() {
+    const int                   objects = 20, frames = 1000;
+    Scene                       scene(1, objects);
+    BYTETracker                 tracker;
+    vector<BYTETracker::Object> detections;
+    vector<int>                 visible;
+    map<int, int>               last;  // object -> track id
+    long                        matched = 0, switches = 0;
+    scene.blink = 0;
+    for (int f = 0; f < frames; f++) {
+        scene.step(detections, visible);
+        for (const STrack& t : tracker.update(detections)) {
+            CHECK(t.object >= 0 && t.object < static_cast<int>(detections.size()));
+            CHECK(t.label == detections[t.object].label);
+            int  o  = visible[t.object];
+            auto it = last.find(o);
+            if (it != last.end() && it->second != t.track_id) switches += 1;
+            last[o] = t.track_id;
+            matched += 1;
+        }
+    }
+    printf("  %ld matched, %ld id switches\n", matched, switches);
+    CHECK(matched > frames * objects * 8 / 10);
+    CHECK(switches * 1000 < matched);
+}
+
+// more objects than BYTE_TRACKER_MAX_TRACKS: the surplus goes untracked, nothing breaks
+static void test_track_cap() {
+    BYTETracker                 tracker;
+    vector<BYTETracker::Object> detections;
+    for (int i = 0; i < BYTE_TRACKER_MAX_TRACKS + 16; i++) {
+        detections.push_back(box((i % 16) * 40.f, (i / 16) * 50.f, 30, 40, 0));
+    }
+    for (int f = 0; f < 5; f++) {
+        const vector<STrack>& out = tracker.update(detections);
+        CHECK(out.size() <= BYTE_TRACKER_MAX_TRACKS);
+        set<int> ids;
+        for (const STrack& t : out) ids.insert(t.track_id);
+        CHECK(ids.size() == out.size());
+    }
+}
+
+// LapJV against every permutation of small square problems
+static void test_lapjv() {
+    Scene scene(5, 0);
+    LapJV lap;
+    for (int trial = 0; trial < 2000; trial++) {
+        int                  n = 1 + static_cast<int>(scene.uniform() * 6);
+        vector<track_real_t> cost(n * n);
+        for (track_real_t& c : cost) c = scene.uniform() < 0.3f ? track_real_t(1) : track_real_t(scene.uniform());
+
+        vector<int> x(n), y(n);
+        CHECK(lap.solve(cost.data(), n, n, x.data(), y.data()) == 0);
+        double got = 0;
+        for (int i = 0; i < n; i++) {
+            CHECK(x[i] >= 0 && x[i] < n && y[x[i]] == i);
+            got += static_cast<double>(cost[i * n + x[i]]);
+        }
+
+        vector<int> perm(n);
+        for (int i = 0; i < n; i++) perm[i] = i;
+        double best = 1e30;
+        do {
+            double sum = 0;
+            for (int i = 0; i < n; i++) sum += static_cast<double>(cost[i * n + perm[i]]);
+            best = min(best, sum);
+        } while (next_permutation(perm.begin(), perm.end()));
+        CHECK(fabs(got - best) < 1e-3);
+    }
+}
+
+// every state keeps some process noise, in Q16.16 too, where the aspect ratio velocity's std of 1e-5 squares to 0
+static void test_kalman_noise() {
+    byte_kalman::KalmanFilter filter;
+    byte_kalman::KalmanStates states;
+    const track_real_t        measurement[4] = {320, 240, track_real_t(0.5f), 80};
+    states.resize(1);
+    filter.initiate(measurement, states.mean(0), states.covariance(0), states.stride());
+    states.mask[0] = KAL_PREDICT_TRACKED;
+    for (int i = 0; i < 4; i++) {
+        CHECK(states.covariance(0)[(KAL_PP + i) * states.stride()] > track_real_t(0));
+        CHECK(states.covariance(0)[(KAL_VV + i) * states.stride()] > track_real_t(0));
+    }
+    track_real_t before = states.covariance(0)[(KAL_VV + 2) * states.stride()];
+    filter.multi_predict(states);
+    CHECK(states.covariance(0)[(KAL_VV + 2) * states.stride()] > before);
+}
+
+#ifdef TRACKER_EIGEN_REFERENCE
+// the packed Kalman filter against the Eigen one it replaced: they round differently, so over a replay the
+// means drift by about one float ulp of the coordinates (3e-5 px near 320) and covariances by 3e-5 relative
+static void test_kalman_eigen() {
+    KalmanDrift drift = kalman_drift(32, 300);
+    printf("  %ld of %ld values differ, worst mean error %.3g, worst relative covariance error %.3g\n",
+           drift.differing,
+           drift.values,
+           drift.worst_mean,
+           drift.worst_cov);
+    CHECK(drift.worst_mean < 1e-4);
+    CHECK(drift.worst_cov < 1e-4);
+}
+#endif
+
+int main() {
+    struct {
+        const char* name;
+        void (*run)();
+    } tests[] = {
+      {"still_object", test_still_object},
+      {"moving_objects", test_moving_objects},
+      {"occlusion", test_occlusion},
+      {"crossing_labels", test_crossing_labels},
+      {"scene", test_scene},
+      {"track_cap", test_track_cap},
+      {"lapjv", test_lapjv},
+      {"kalman_noise", test_kalman_noise},
+#ifdef TRACKER_EIGEN_REFERENCE
+      {"kalman_eigen", test_kalman_eigen},
+#endif
+    };
+    for (const auto& test : tests) {
+        int before = failures;
+        printf("%s\n", test.name);
+        test.run();
+        printf("  %s\n", failures == before ? "ok" : "FAILED");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+// Runs the tracker over a seeded scene and prints what it tracked, for compare_tracker to hold the float and
+// the Q16.16 builds against each other: a "frame object track_id" line per output track, then "time" and the
+// best time of one update() in microseconds over a few replays.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "BYTETracker.h"
+#include "scene.h"
+
+using namespace std;
+
+static const int objects = 20, frames = 1000;
+
+int main() {
+    double best = 1e30;
+    for (int run = 0; run < 5; run++) {
+        Scene                       scene(1, objects);
+        BYTETracker                 tracker;
+        vector<BYTETracker::Object> detections;
+        vector<int>                 visible;
+        double                      us = 0;
+        for (int f = 0; f < frames; f++) {
+            scene.step(detections, visible);
+            auto                  begin  = chrono::steady_clock::now();
+            const vector<STrack>& tracks = tracker.update(detections);
+            us += chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count();
+            if (run > 0) continue;
+            for (const STrack& t : tracks) printf("%d %d %d\n", f, visible[t.object], t.track_id);
+        }
+        best = min(best, us / frames);
+    }
+    printf("time %.3f\n", best);
+    return 0;
+}
@@ -27,6 +27,15 @@
 
 #include "Seeed_Arduino_SSCMA.h"
 
+#include <algorithm>
+#include <new>
+
+#include "tracker/BYTETracker.h"
+
+#if SSCMA_HAS_IO_TASK && defined(ARDUINO_ARCH_ESP32)
+#include <esp_pthread.h>
+#endif
+
 #ifdef ARDUINO_ARCH_RENESAS
 char *strnstr(const char *haystack, const char *needle, size_t n)
 {
@@ -66,6 +75,13 @@ char *strnstr(const char *haystack, const char *needle, size_t n)
 }
 #endif
 
+static bool is_invoke_event(const char *payload, size_t len)
+{
+    // "type" and "name" lead every reply, no need to scan the whole payload
+    size_t head = len < 64 ? len : 64;
+    return strnstr(payload, "\"type\": 1", head) && strnstr(payload, "\"name\": \"INVOKE\"", head);
+}
+
 #define SPI_CS(x)                 \
     do                            \
     {                             \
@@ -85,9 +101,27 @@ SSCMA::SSCMA()
     _sync = -1;
     tx_len = 0;
     rx_len = 0;
+#if SSCMA_HAS_IO_TASK
+    for (size_t i = 0; i < SSCMA_MAILBOX_SIZE; i++)
+    {
+        _mailbox[i].state = IO_FREE;
+    }
+    _mailbox_ticket = 0;
+    _io_running = false;
+#endif
+    for (size_t i = 0; i < SSCMA_RESULT_BUFFERS; i++)
+    {
+        _results[i].refs = 0;
+    }
+    _results_front = -1;
 }
 
-SSCMA::~SSCMA() {}
+SSCMA::~SSCMA()
+{
+#if SSCMA_HAS_IO_TASK
+    stop_io_task();
+#endif
+}
 
 bool SSCMA::begin(TwoWire *wire, int32_t rst, uint16_t address, uint32_t wait_delay,
                   uint32_t clock)
@@ -105,16 +139,7 @@ bool SSCMA::begin(TwoWire *wire, int32_t rst, uint16_t address, uint32_t wait_de
 
     response.clear();
 
-    if (_rst >= 0)
-    {
-        pinMode(_rst, OUTPUT);
-        digitalWrite(_rst, LOW);
-        delay(50);
-        pinMode(_rst, INPUT);
-        delay(500);
-    }
-
-    return ID(false) && name(false);
+    return handshake();
 }
 
 bool SSCMA::begin(HardwareSerial *serial, int32_t rst, uint32_t baud,
@@ -122,6 +147,7 @@ bool SSCMA::begin(HardwareSerial *serial, int32_t rst, uint32_t baud,
 {
     _serial = serial;
     _wire = NULL;
+    _rst = rst;
     _baud = baud;
     _wait_delay = wait_delay;
     _serial->begin(_baud);
@@ -133,16 +159,7 @@ bool SSCMA::begin(HardwareSerial *serial, int32_t rst, uint32_t baud,
 
     response.clear();
 
-    if (_rst >= 0)
-    {
-        pinMode(_rst, OUTPUT);
-        digitalWrite(_rst, LOW);
-        delay(50);
-        pinMode(_rst, INPUT);
-        delay(500);
-    }
-
-    return ID(false) && name(false);
+    return handshake();
 }
 
 bool SSCMA::begin(SPIClass *spi, int32_t cs, int32_t sync, int32_t rst, uint32_t baud, uint32_t wait_delay)
@@ -172,22 +189,315 @@ bool SSCMA::begin(SPIClass *spi, int32_t cs, int32_t sync, int32_t rst, uint32_t
 
     response.clear();
 
+    return handshake();
+}
+
+bool SSCMA::handshake()
+{
+    char cmd[64] = {0};
+    uint32_t backoff = 10;
+
     if (_rst >= 0)
     {
         pinMode(_rst, OUTPUT);
         digitalWrite(_rst, LOW);
-        delay(50);
+        delay(SSCMA_RESET_PULSE);
         pinMode(_rst, INPUT);
-        delay(500);
     }
 
-    spi_cmd(FEATURE_TRANSPORT, FEATURE_TRANSPORT_CMD_RESET, 0, NULL);
+    if (_spi)
+    {
+        spi_cmd(FEATURE_TRANSPORT, FEATURE_TRANSPORT_CMD_RESET, 0, NULL);
+    }
+
+    // ping with ID? until the device answers instead of sleeping for the worst case boot time
+    uint32_t start = millis();
+    snprintf(cmd, sizeof(cmd), CMD_PREFIX "%s" CMD_SUFFIX, CMD_AT_ID);
+    while (true)
+    {
+        write(cmd, strlen(cmd));
+        if (wait(CMD_TYPE_RESPONSE, CMD_AT_ID, backoff) == CMD_OK)
+        {
+            strcpy(_ID, response["data"]);
+            break;
+        }
+        if (millis() - start > SSCMA_READY_TIMEOUT)
+        {
+            return false;
+        }
+        backoff = backoff < 100 ? backoff * 2 : 200;
+    }
+    _ready_time = millis() - start;
+
+    uint32_t hash = 0;
+    if (_cache)
+    {
+        hash = version_hash();
+        if (hash && cache_load(hash))
+        {
+            return true;
+        }
+    }
+
+    // the device answers in order, so the queries can be sent back to back
+    snprintf(cmd, sizeof(cmd), CMD_PREFIX "%s" CMD_SUFFIX CMD_PREFIX "%s?" CMD_SUFFIX, CMD_AT_NAME, CMD_AT_INFO);
+    write(cmd, strlen(cmd));
+    if (_cache)
+    {
+        snprintf(cmd, sizeof(cmd), CMD_PREFIX "%s?" CMD_SUFFIX CMD_PREFIX "%s?" CMD_SUFFIX, CMD_AT_MODELS, CMD_AT_SENSORS);
+        write(cmd, strlen(cmd));
+    }
+
+    if (wait(CMD_TYPE_RESPONSE, CMD_AT_NAME, 3000) != CMD_OK)
+    {
+        return false;
+    }
+    strcpy(_name, response["data"]);
+
+    if (wait(CMD_TYPE_RESPONSE, CMD_AT_INFO, 3000) == CMD_OK)
+    {
+        _info = response["data"]["info"].as<String>();
+    }
+
+    if (_cache)
+    {
+        if (wait(CMD_TYPE_RESPONSE, "MODELS?", 3000) == CMD_OK)
+        {
+            _models = "";
+            serializeJson(response["data"], _models);
+        }
+        if (wait(CMD_TYPE_RESPONSE, "SENSORS?", 3000) == CMD_OK)
+        {
+            _sensors = "";
+            serializeJson(response["data"], _sensors);
+        }
+        if (hash)
+        {
+            cache_store(hash);
+        }
+    }
+
+    return true;
+}
+
+static uint32_t fnv1a(const char *data, uint32_t hash = 2166136261UL)
+{
+    while (*data)
+    {
+        hash ^= (uint8_t)*data++;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+// firmware version and the loaded model decide whether the cached info is still valid
+uint32_t SSCMA::version_hash()
+{
+    char cmd[64] = {0};
+    String data;
+    uint32_t hash = 0;
+
+    snprintf(cmd, sizeof(cmd), CMD_PREFIX "%s" CMD_SUFFIX CMD_PREFIX "%s?" CMD_SUFFIX, CMD_AT_VERSION, CMD_AT_MODEL);
+    write(cmd, strlen(cmd));
+
+    if (wait(CMD_TYPE_RESPONSE, CMD_AT_VERSION) == CMD_OK)
+    {
+        serializeJson(response["data"], data);
+        hash = fnv1a(data.c_str());
+    }
+    if (wait(CMD_TYPE_RESPONSE, "MODEL?") == CMD_OK)
+    {
+        data = "";
+        serializeJson(response["data"], data);
+        hash = fnv1a(data.c_str(), hash);
+    }
+
+    return hash;
+}
+
+bool SSCMA::cache_load(uint32_t hash)
+{
+    char key[64] = {0};
+    String value;
+
+    snprintf(key, sizeof(key), "%s.hash", _ID);
+    if (!_cache->get(key, value) || strtoul(value.c_str(), NULL, 16) != hash)
+    {
+        return false;
+    }
+
+    snprintf(key, sizeof(key), "%s.name", _ID);
+    if (!_cache->get(key, value) || value.length() == 0)
+    {
+        return false;
+    }
+    strncpy(_name, value.c_str(), sizeof(_name) - 1);
+
+    snprintf(key, sizeof(key), "%s.info", _ID);
+    _cache->get(key, _info);
+    snprintf(key, sizeof(key), "%s.models", _ID);
+    _cache->get(key, _models);
+    snprintf(key, sizeof(key), "%s.sensors", _ID);
+    _cache->get(key, _sensors);
+
+    return true;
+}
+
+void SSCMA::cache_store(uint32_t hash)
+{
+    char key[64] = {0};
+    char value[16] = {0};
+
+    snprintf(key, sizeof(key), "%s.name", _ID);
+    _cache->set(key, _name);
+    snprintf(key, sizeof(key), "%s.info", _ID);
+    _cache->set(key, _info);
+    snprintf(key, sizeof(key), "%s.models", _ID);
+    _cache->set(key, _models);
+    snprintf(key, sizeof(key), "%s.sensors", _ID);
+    _cache->set(key, _sensors);
+
+    // written last, so an interrupted store is never taken as valid
+    snprintf(key, sizeof(key), "%s.hash", _ID);
+    snprintf(value, sizeof(value), "%08lx", (unsigned long)hash);
+    _cache->set(key, value);
+}
+
+#if SSCMA_FILE_CACHE
+SSCMAFileCache::SSCMAFileCache(const char *dir)
+{
+    strncpy(_dir, dir, sizeof(_dir) - 1);
+    _dir[sizeof(_dir) - 1] = '\0';
+}
+
+bool SSCMAFileCache::get(const char *key, String &value)
+{
+    char path[128] = {0};
+    snprintf(path, sizeof(path), "%s/%s", _dir, key);
+
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *buf = size >= 0 ? (char *)malloc(size + 1) : NULL;
+    if (!buf)
+    {
+        fclose(file);
+        return false;
+    }
+
+    bool ok = fread(buf, 1, size, file) == (size_t)size;
+    fclose(file);
+    if (ok)
+    {
+        buf[size] = '\0';
+        value = buf;
+    }
+    free(buf);
+
+    return ok;
+}
+
+bool SSCMAFileCache::set(const char *key, const String &value)
+{
+    char path[128] = {0};
+    snprintf(path, sizeof(path), "%s/%s", _dir, key);
+
+    FILE *file = fopen(path, "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    bool ok = fwrite(value.c_str(), 1, value.length(), file) == value.length();
+    fclose(file);
+
+    return ok;
+}
+#endif
+
+struct SSCMAByteTracker::state_t
+{
+    state_t(int frame_rate, int track_buffer) : tracker(frame_rate, track_buffer) {}
+
+    BYTETracker tracker;
+    std::vector<BYTETracker::Object> objects;
+};
+
+SSCMAByteTracker::SSCMAByteTracker(int frame_rate, int track_buffer)
+{
+    _state = new (std::nothrow) state_t(frame_rate, track_buffer);
+}
+
+SSCMAByteTracker::~SSCMAByteTracker()
+{
+    delete _state;
+}
+
+static inline boxes_t &box_of(boxes_t &box)
+{
+    return box;
+}
+
+static inline boxes_t &box_of(keypoints_t &keypoint)
+{
+    return keypoint.box;
+}
+
+template <typename T>
+static void track_results(BYTETracker &tracker, std::vector<BYTETracker::Object> &objects, std::vector<T> &results)
+{
+    objects.resize(results.size());
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        boxes_t &box = box_of(results[i]);
+        // the device sends box centers, the tracker takes the top left corner
+        objects[i].rect.x = box.x - box.w / 2.0f;
+        objects[i].rect.y = box.y - box.h / 2.0f;
+        objects[i].rect.width = box.w;
+        objects[i].rect.height = box.h;
+        objects[i].label = box.target;
+        objects[i].prob = box.score / 100.0f;
+        box.track_id = 0;
+    }
+
+    const std::vector<STrack> &tracks = tracker.update(objects);
+    for (const STrack &track : tracks)
+    {
+        box_of(results[track.object]).track_id = track.track_id;
+    }
+}
+
+void SSCMAByteTracker::track(std::vector<boxes_t> &boxes)
+{
+    if (_state)
+    {
+        track_results(_state->tracker, _state->objects, boxes);
+    }
+}
 
-    return ID(false) && name(false);
+void SSCMAByteTracker::track(std::vector<keypoints_t> &keypoints)
+{
+    if (_state)
+    {
+        track_results(_state->tracker, _state->objects, keypoints);
+    }
 }
 
 int SSCMA::write(const char *data, int length)
 {
+    // any other command ends pipelining, after the INVOKE in flight has been drained
+    if ((_pipeline || _pipeline_pending) && data != _pipeline_cmd)
+    {
+        invoke_pipeline_stop();
+    }
+
     // Serial.print("write[");
     // Serial.print(length);
     // Serial.print("]: ");
@@ -441,32 +751,244 @@ int SSCMA::spi_write(const char *data, int length)
     return length;
 }
 
-void SSCMA::praser_event()
+static inline uint8_t score_of(const boxes_t &b) { return b.score; }
+static inline uint8_t score_of(const classes_t &c) { return c.score; }
+static inline uint8_t score_of(const point_t &p) { return p.score; }
+static inline uint8_t score_of(const keypoints_t &k) { return k.box.score; }
+
+template <typename T>
+static bool score_greater(const T &a, const T &b)
 {
-    if (strstr(response["name"], CMD_AT_INVOKE))
+    return score_of(a) > score_of(b);
+}
+
+// with top-k enabled the results are kept as a min-heap of at most k entries
+template <typename T>
+static bool top_k_admits(const std::vector<T> &results, uint8_t score, uint16_t k)
+{
+    return k == 0 || results.size() < k || score > score_of(results.front());
+}
+
+template <typename T>
+static void top_k_push(std::vector<T> &results, T &item, uint16_t k)
+{
+    if (k == 0)
     {
-        if (response["data"].containsKey("perf"))
+        results.push_back(std::move(item));
+        return;
+    }
+    if (results.size() >= k)
+    {
+        std::pop_heap(results.begin(), results.end(), score_greater<T>);
+        results.pop_back();
+    }
+    results.push_back(std::move(item));
+    std::push_heap(results.begin(), results.end(), score_greater<T>);
+}
+
+template <typename T>
+static void top_k_finish(std::vector<T> &results, uint16_t k)
+{
+    if (k)
+    {
+        std::sort_heap(results.begin(), results.end(), score_greater<T>); // highest score first
+    }
+}
+
+void SSCMA::filter_score(uint8_t score)
+{
+    _filter.score = score;
+}
+
+void SSCMA::filter_target(uint8_t target, bool allow)
+{
+    if (allow)
+    {
+        _filter.targets[target >> 5] |= 1UL << (target & 31);
+    }
+    else
+    {
+        _filter.targets[target >> 5] &= ~(1UL << (target & 31));
+    }
+}
+
+void SSCMA::filter_roi(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    _filter.roi_x = x;
+    _filter.roi_y = y;
+    _filter.roi_w = w;
+    _filter.roi_h = h;
+}
+
+void SSCMA::filter_top_k(uint16_t k)
+{
+    _filter.top_k = k;
+    if (k)
+    {
+        _boxes.reserve(k);
+        _classes.reserve(k);
+        _points.reserve(k);
+        _keypoints.reserve(k);
+    }
+}
+
+void SSCMA::filter_clear()
+{
+    memset(&_filter, 0, sizeof(_filter));
+}
+
+bool SSCMA::filter_accept(uint8_t score, uint8_t target)
+{
+    if (score < _filter.score)
+    {
+        return false;
+    }
+
+    bool any = false;
+    for (size_t i = 0; i < sizeof(_filter.targets) / sizeof(_filter.targets[0]); i++)
+    {
+        any |= _filter.targets[i] != 0;
+    }
+    if (any && !(_filter.targets[target >> 5] & (1UL << (target & 31))))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool SSCMA::filter_accept(uint16_t x, uint16_t y, uint8_t score, uint8_t target)
+{
+    if (_filter.roi_w && _filter.roi_h)
+    {
+        if (x < _filter.roi_x || x >= _filter.roi_x + _filter.roi_w ||
+            y < _filter.roi_y || y >= _filter.roi_y + _filter.roi_h)
         {
-            _perf.prepocess = response["data"]["perf"][0];
-            _perf.inference = response["data"]["perf"][1];
-            _perf.postprocess = response["data"]["perf"][2];
+            return false;
         }
+    }
 
-        if (response["data"].containsKey("boxes"))
+    return filter_accept(score, target);
+}
+
+void SSCMA::on_boxes_change(DeltaCallback callback, uint16_t tolerance)
+{
+    _delta_callback = callback;
+    _delta_tolerance = tolerance;
+    _last_boxes.clear();
+}
+
+static inline uint16_t distance(uint16_t a, uint16_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+void SSCMA::detect_change()
+{
+    _delta.clear();
+    _last_matched.assign(_last_boxes.size(), 0);
+
+    for (size_t i = 0; i < _boxes.size(); i++)
+    {
+        const boxes_t &cur = _boxes[i];
+        int best = -1;
+        uint16_t best_dist = 0xFFFF;
+
+        // nearest unmatched box of the same target from the last frame
+        for (size_t j = 0; j < _last_boxes.size(); j++)
         {
-            _boxes.clear();
-            JsonArray boxes = response["data"]["boxes"];
-            for (size_t i = 0; i < boxes.size(); i++)
+            const boxes_t &last = _last_boxes[j];
+            if (_last_matched[j] || last.target != cur.target)
             {
-                JsonArray box = boxes[i];
-                boxes_t b;
-                b.x = box[0];
-                b.y = box[1];
-                b.w = box[2];
-                b.h = box[3];
+                continue;
+            }
+            uint16_t dist = std::max<uint16_t>(std::max<uint16_t>(distance(cur.x, last.x), distance(cur.y, last.y)),
+                                               std::max<uint16_t>(distance(cur.w, last.w), distance(cur.h, last.h)));
+            // farther than its own size away is another object
+            if (dist > _delta_tolerance && dist > std::max<uint16_t>(last.w, last.h))
+            {
+                continue;
+            }
+            if (dist < best_dist)
+            {
+                best = j;
+                best_dist = dist;
+            }
+        }
+
+        if (best < 0)
+        {
+            _delta.push_back({DELTA_ADDED, cur});
+            continue;
+        }
+        _last_matched[best] = 1;
+        if (best_dist > _delta_tolerance)
+        {
+            _delta.push_back({DELTA_MOVED, cur});
+        }
+    }
+
+    for (size_t j = 0; j < _last_boxes.size(); j++)
+    {
+        if (!_last_matched[j])
+        {
+            _delta.push_back({DELTA_REMOVED, _last_boxes[j]});
+        }
+    }
+
+    _last_boxes.assign(_boxes.begin(), _boxes.end());
+
+    if (!_delta.empty())
+    {
+        _delta_callback(_delta);
+    }
+}
+
+void SSCMA::praser_event()
+{
+    if (strstr(response["name"], CMD_AT_INVOKE))
+    {
+        _frame_seq++;
+
+        if (response["data"].containsKey("perf"))
+        {
+            _perf.prepocess = response["data"]["perf"][0];
+            _perf.inference = response["data"]["perf"][1];
+            _perf.postprocess = response["data"]["perf"][2];
+        }
+
+        if (response["data"].containsKey("boxes"))
+        {
+            _boxes.clear();
+            JsonArray boxes = response["data"]["boxes"];
+            for (size_t i = 0; i < boxes.size(); i++)
+            {
+                JsonArray box = boxes[i];
+                boxes_t b;
+                b.x = box[0];
+                b.y = box[1];
                 b.score = box[4];
                 b.target = box[5];
-                _boxes.push_back(b);
+                if (!filter_accept(b.x, b.y, b.score, b.target) ||
+                    !top_k_admits(_boxes, b.score, _filter.top_k))
+                {
+                    continue;
+                }
+                b.w = box[2];
+                b.h = box[3];
+                b.track_id = 0;
+                top_k_push(_boxes, b, _filter.top_k);
+            }
+            top_k_finish(_boxes, _filter.top_k);
+
+            if (_tracker)
+            {
+                _tracker->track(_boxes);
+            }
+
+            if (_delta_callback)
+            {
+                detect_change();
             }
         }
 
@@ -480,8 +1002,14 @@ void SSCMA::praser_event()
                 classes_t c;
                 c.target = cls[1];
                 c.score = cls[0];
-                _classes.push_back(c);
+                if (!filter_accept(c.score, c.target) ||
+                    !top_k_admits(_classes, c.score, _filter.top_k))
+                {
+                    continue;
+                }
+                top_k_push(_classes, c, _filter.top_k);
             }
+            top_k_finish(_classes, _filter.top_k);
         }
 
         if (response["data"].containsKey("points"))
@@ -497,8 +1025,14 @@ void SSCMA::praser_event()
                 // p.z = point[2];
                 p.score = point[2];
                 p.target = point[3];
-                _points.push_back(p);
+                if (!filter_accept(p.x, p.y, p.score, p.target) ||
+                    !top_k_admits(_points, p.score, _filter.top_k))
+                {
+                    continue;
+                }
+                top_k_push(_points, p, _filter.top_k);
             }
+            top_k_finish(_points, _filter.top_k);
         }
 
         if (response["data"].containsKey("keypoints"))
@@ -509,14 +1043,22 @@ void SSCMA::praser_event()
             {
                 keypoints_t k;
                 JsonArray box = keypoints[i][0];
-                JsonArray points = keypoints[i][1];
                 k.box.x = box[0];
                 k.box.y = box[1];
-                k.box.w = box[2];
-                k.box.h = box[3];
                 k.box.score = box[4];
                 k.box.target = box[5];
+                // rejected boxes never get their points decoded
+                if (!filter_accept(k.box.x, k.box.y, k.box.score, k.box.target) ||
+                    !top_k_admits(_keypoints, k.box.score, _filter.top_k))
+                {
+                    continue;
+                }
+                k.box.w = box[2];
+                k.box.h = box[3];
+                k.box.track_id = 0;
 
+                JsonArray points = keypoints[i][1];
+                k.points.reserve(points.size());
                 for (size_t j = 0; j < points.size(); j++)
                 {
                     point_t p;
@@ -527,13 +1069,21 @@ void SSCMA::praser_event()
                     p.target = points[j][3];
                     k.points.push_back(p);
                 }
-                _keypoints.push_back(k);
+                top_k_push(_keypoints, k, _filter.top_k);
+            }
+            top_k_finish(_keypoints, _filter.top_k);
+
+            if (_tracker)
+            {
+                _tracker->track(_keypoints);
             }
         }
         if (response["data"].containsKey("image"))
         {
             _image = response["data"]["image"].as<String>();
         }
+
+        publish();
     }
 }
 void SSCMA::praser_log()
@@ -579,6 +1129,12 @@ int SSCMA::wait(int type, const char *cmd, uint32_t timeout)
                 memmove(rx_buf, suffix + RESPONSE_SUFFIX_LEN, rx_end - (suffix - rx_buf) - RESPONSE_SUFFIX_LEN);
                 rx_end -= suffix - rx_buf + RESPONSE_SUFFIX_LEN;
                 payload[len - 1] = '\0';
+
+                if (is_invoke_event(payload, len - 1))
+                {
+                    // a pipelined INVOKE is only sent on while INVOKE results are being waited for
+                    invoke_event(strcmp(cmd, CMD_AT_INVOKE) == 0);
+                }
                 //Serial.printf("\npayload :%s", payload);
                 // parse json response
                 // for(size_t i = 0; i < strlen(payload); i++){
@@ -673,6 +1229,34 @@ void SSCMA::fetch(ResponseCallback RespCallback)
     }
 }
 
+void SSCMA::invoke_send(const char *cmd)
+{
+    if (_invoke_idle)
+    {
+        _invoke_idle_us += micros() - _invoke_event_us;
+        _invoke_idle = false;
+    }
+    if (_invoke_begin == 0)
+    {
+        _invoke_begin = millis();
+    }
+    write(cmd, strlen(cmd));
+}
+
+void SSCMA::invoke_event(bool pipeline)
+{
+    _invoke_frames++;
+    _invoke_event_us = micros();
+    _invoke_idle = true;
+
+    // the device starts on the next frame while we are still decoding this one
+    if (_pipeline && pipeline)
+    {
+        invoke_send(_pipeline_cmd);
+        _pipeline_pending = true;
+    }
+}
+
 int SSCMA::invoke(int times, bool filter, bool show)
 {
     char cmd[64] = {0};
@@ -682,9 +1266,114 @@ int SSCMA::invoke(int times, bool filter, bool show)
         return CMD_ENOTSUP;
     }
 
+    if (_pipeline || _pipeline_pending)
+    {
+        invoke_pipeline_stop();
+    }
+
     snprintf(cmd, sizeof(cmd), CMD_PREFIX "%s=%d,%d,%d" CMD_SUFFIX,
              CMD_AT_INVOKE, times, !filter, filter); // AT+INVOKE=1,0,1\r\n
-    write(cmd, strlen(cmd));
+    invoke_send(cmd);
+
+    if (wait(CMD_TYPE_RESPONSE, CMD_AT_INVOKE) == CMD_OK)
+    {
+        // consume every event of a multi-frame invoke so none is left
+        // behind for the next wait(), results hold the last frame
+        for (int i = 0; i < (times > 1 ? times : 1); i++)
+        {
+            if (wait(CMD_TYPE_EVENT, CMD_AT_INVOKE) != CMD_OK)
+            {
+                return CMD_ETIMEDOUT;
+            }
+        }
+        return CMD_OK;
+    }
+
+    return CMD_ETIMEDOUT;
+}
+
+int SSCMA::invoke_batch(int n, batch_t &sink, bool filter)
+{
+    char cmd[64] = {0};
+
+    sink.count = 0;
+    sink.frames = 0;
+    sink.dropped = 0;
+
+    if (n <= 0 || (sink.size && !sink.boxes))
+    {
+        return CMD_EINVAL;
+    }
+
+    if (_pipeline || _pipeline_pending)
+    {
+        invoke_pipeline_stop();
+    }
+
+    snprintf(cmd, sizeof(cmd), CMD_PREFIX "%s=%d,%d,%d" CMD_SUFFIX,
+             CMD_AT_INVOKE, n, !filter, filter);
+    invoke_send(cmd);
+
+    if (wait(CMD_TYPE_RESPONSE, CMD_AT_INVOKE) != CMD_OK)
+    {
+        return CMD_ETIMEDOUT;
+    }
+
+    while (sink.frames < (uint32_t)n)
+    {
+        if (wait(CMD_TYPE_EVENT, CMD_AT_INVOKE) != CMD_OK)
+        {
+            // stop the device so the rest of the batch does not leak into later commands
+            snprintf(cmd, sizeof(cmd), CMD_PREFIX "%s" CMD_SUFFIX, CMD_AT_BREAK);
+            write(cmd, strlen(cmd));
+            wait(CMD_TYPE_RESPONSE, CMD_AT_BREAK);
+            return CMD_ETIMEDOUT;
+        }
+
+        if (sink.perf)
+        {
+            sink.perf[sink.frames] = _perf;
+        }
+
+        // _boxes is only refreshed by events that carry boxes
+        if (response["data"].containsKey("boxes"))
+        {
+            for (size_t i = 0; i < _boxes.size(); i++)
+            {
+                if (sink.count >= sink.size)
+                {
+                    sink.dropped += _boxes.size() - i;
+                    break;
+                }
+                sink.boxes[sink.count].frame = sink.frames;
+                sink.boxes[sink.count].box = _boxes[i];
+                sink.count++;
+            }
+        }
+
+        sink.frames++;
+    }
+
+    return CMD_OK;
+}
+
+int SSCMA::invoke_pipelined(bool filter, bool show)
+{
+    if (show && rx_len < 16 * 1024)
+    {
+        return CMD_ENOTSUP;
+    }
+
+    snprintf(_pipeline_cmd, sizeof(_pipeline_cmd), CMD_PREFIX "%s=%d,%d,%d" CMD_SUFFIX,
+             CMD_AT_INVOKE, 1, !filter, filter);
+
+    // only the first frame is sent from here, the rest are sent by wait()
+    if (!_pipeline_pending)
+    {
+        invoke_send(_pipeline_cmd);
+    }
+    _pipeline_pending = false;
+    _pipeline = true;
 
     if (wait(CMD_TYPE_RESPONSE, CMD_AT_INVOKE) == CMD_OK)
     {
@@ -694,9 +1383,58 @@ int SSCMA::invoke(int times, bool filter, bool show)
         }
     }
 
+    _pipeline = false;
     return CMD_ETIMEDOUT;
 }
 
+int SSCMA::invoke_pipeline_stop()
+{
+    _pipeline = false;
+    if (!_pipeline_pending)
+    {
+        return CMD_OK;
+    }
+    _pipeline_pending = false;
+
+    // drain the INVOKE that is already in flight
+    if (wait(CMD_TYPE_RESPONSE, CMD_AT_INVOKE) == CMD_OK)
+    {
+        if (wait(CMD_TYPE_EVENT, CMD_AT_INVOKE) == CMD_OK)
+        {
+            return CMD_OK;
+        }
+    }
+
+    return CMD_ETIMEDOUT;
+}
+
+invoke_stats_t SSCMA::invoke_stats()
+{
+    invoke_stats_t stats;
+    uint64_t idle_us = _invoke_idle_us;
+
+    if (_invoke_idle)
+    {
+        idle_us += micros() - _invoke_event_us;
+    }
+
+    stats.frames = _invoke_frames;
+    stats.elapsed = _invoke_begin ? millis() - _invoke_begin : 0;
+    stats.idle = idle_us / 1000;
+    stats.fps = stats.elapsed ? stats.frames * 1000.0f / stats.elapsed : 0;
+    stats.idle_ratio = stats.elapsed ? (float)stats.idle / stats.elapsed : 0;
+
+    return stats;
+}
+
+void SSCMA::invoke_stats_reset()
+{
+    _invoke_frames = 0;
+    _invoke_begin = 0;
+    _invoke_idle = false;
+    _invoke_idle_us = 0;
+}
+
 int SSCMA::WIFI(wifi_t &wifi)
 {
     char cmd[64] = {0};
@@ -738,7 +1476,7 @@ int SSCMA::MQTT(mqtt_t &mqtt)
 
 char *SSCMA::ID(bool cache)
 {
-    if (cache && _ID)
+    if (cache && _ID[0])
     {
         return _ID;
     }
@@ -798,6 +1536,52 @@ String SSCMA::info(bool cache)
     return "";
 }
 
+String SSCMA::models(bool cache)
+{
+    if (cache && _models.length())
+    {
+        return _models;
+    }
+
+    char cmd[64] = {0};
+
+    snprintf(cmd, sizeof(cmd), CMD_PREFIX "%s?" CMD_SUFFIX, CMD_AT_MODELS);
+
+    write(cmd, strlen(cmd));
+
+    if (wait(CMD_TYPE_RESPONSE, "MODELS?", 3000) == CMD_OK)
+    {
+        _models = "";
+        serializeJson(response["data"], _models);
+        return _models;
+    }
+
+    return "";
+}
+
+String SSCMA::sensors(bool cache)
+{
+    if (cache && _sensors.length())
+    {
+        return _sensors;
+    }
+
+    char cmd[64] = {0};
+
+    snprintf(cmd, sizeof(cmd), CMD_PREFIX "%s?" CMD_SUFFIX, CMD_AT_SENSORS);
+
+    write(cmd, strlen(cmd));
+
+    if (wait(CMD_TYPE_RESPONSE, "SENSORS?", 3000) == CMD_OK)
+    {
+        _sensors = "";
+        serializeJson(response["data"], _sensors);
+        return _sensors;
+    }
+
+    return "";
+}
+
 int SSCMA::WIFISTA(wifi_status_t &wifi_status)
 {
     char cmd[128] = {0};
@@ -845,6 +1629,243 @@ int SSCMA::WIFIVER(char *version)
     return CMD_ETIMEDOUT;
 }
 
+#if SSCMA_HAS_IO_TASK
+bool SSCMA::start_io_task(ResponseCallback callback, uint32_t stack_size)
+{
+    if (_io_running)
+    {
+        return false;
+    }
+
+    _io_callback = callback;
+    _io_running = true;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // std::thread takes its stack from the calling task's pthread config, put the caller's back afterwards
+    esp_pthread_cfg_t saved;
+    if (esp_pthread_get_cfg(&saved) != ESP_OK)
+    {
+        saved = esp_pthread_get_default_config();
+    }
+    esp_pthread_cfg_t cfg = saved;
+    cfg.stack_size = stack_size;
+    cfg.thread_name = "sscma_io";
+    esp_pthread_set_cfg(&cfg);
+#else
+    (void)stack_size;
+#endif
+
+    _io_thread = std::thread(&SSCMA::io_loop, this);
+
+#if defined(ARDUINO_ARCH_ESP32)
+    esp_pthread_set_cfg(&saved);
+#endif
+
+    return true;
+}
+
+void SSCMA::stop_io_task()
+{
+    if (!_io_running)
+    {
+        return;
+    }
+
+    _io_running = false;
+    if (_io_thread.joinable())
+    {
+        _io_thread.join();
+    }
+}
+
+int SSCMA::submit(std::function<int(SSCMA &)> op, uint32_t timeout)
+{
+    if (!_io_running || std::this_thread::get_id() == _io_thread.get_id())
+    {
+        return op(*this);
+    }
+
+    io_request_t *req = NULL;
+    for (size_t i = 0; i < SSCMA_MAILBOX_SIZE && !req; i++)
+    {
+        uint8_t expected = IO_FREE;
+        if (_mailbox[i].state.compare_exchange_strong(expected, IO_CLAIMED))
+        {
+            req = &_mailbox[i];
+        }
+    }
+    if (!req)
+    {
+        return CMD_EBUSY;
+    }
+
+    req->op = op;
+    req->ret = CMD_ETIMEDOUT;
+    req->ticket = _mailbox_ticket.fetch_add(1);
+    req->state.store(IO_QUEUED, std::memory_order_release);
+
+    {
+        std::unique_lock<std::mutex> lock(_io_mutex);
+        _io_done.wait_for(lock, std::chrono::milliseconds(timeout),
+                          [req]
+                          { return req->state.load(std::memory_order_acquire) == IO_DONE; });
+    }
+
+    // still queued: leave it to the I/O task to drop it
+    uint8_t expected = IO_QUEUED;
+    if (req->state.compare_exchange_strong(expected, IO_ABANDONED))
+    {
+        return CMD_ETIMEDOUT;
+    }
+
+    // already running, the op may refer to our stack so wait for it
+    if (expected == IO_RUNNING)
+    {
+        std::unique_lock<std::mutex> lock(_io_mutex);
+        _io_done.wait(lock, [req]
+                      { return req->state.load(std::memory_order_acquire) == IO_DONE; });
+    }
+
+    int ret = req->ret;
+    req->op = nullptr;
+    req->state.store(IO_FREE, std::memory_order_release);
+
+    return ret;
+}
+
+void SSCMA::io_loop()
+{
+    while (_io_running)
+    {
+        // oldest request first
+        io_request_t *req = NULL;
+        for (size_t i = 0; i < SSCMA_MAILBOX_SIZE; i++)
+        {
+            uint8_t state = _mailbox[i].state.load(std::memory_order_acquire);
+            if (state == IO_ABANDONED)
+            {
+                _mailbox[i].op = nullptr;
+                _mailbox[i].state.store(IO_FREE, std::memory_order_release);
+            }
+            else if (state == IO_QUEUED && (!req || (int32_t)(_mailbox[i].ticket - req->ticket) < 0))
+            {
+                req = &_mailbox[i];
+            }
+        }
+
+        if (req)
+        {
+            uint8_t expected = IO_QUEUED;
+            if (!req->state.compare_exchange_strong(expected, IO_RUNNING))
+            {
+                continue;
+            }
+            req->ret = req->op(*this);
+            {
+                std::lock_guard<std::mutex> lock(_io_mutex);
+                req->state.store(IO_DONE, std::memory_order_release);
+            }
+            _io_done.notify_all();
+            continue;
+        }
+
+        // nothing to send, keep draining replies and events
+        if (_io_callback)
+        {
+            fetch(_io_callback);
+        }
+        else
+        {
+            wait(CMD_TYPE_EVENT, "", 0);
+        }
+        delay(1);
+    }
+}
+#endif
+
+void SSCMA::publish()
+{
+    int8_t front = _results_front.load();
+    result_buffer_t *back = NULL;
+    for (int8_t i = 0; i < SSCMA_RESULT_BUFFERS; i++)
+    {
+        if (i != front && _results[i].refs.load() == 0)
+        {
+            back = &_results[i];
+            front = i;
+            break;
+        }
+    }
+    if (!back)
+    {
+        _results_dropped++;
+        return;
+    }
+
+    // assign keeps the capacity, so steady state does not allocate
+    back->result.seq = _frame_seq;
+    back->result.timestamp = millis();
+    back->result.perf = _perf;
+    back->result.boxes.assign(_boxes.begin(), _boxes.end());
+    back->result.classes.assign(_classes.begin(), _classes.end());
+    back->result.points.assign(_points.begin(), _points.end());
+    back->result.keypoints.assign(_keypoints.begin(), _keypoints.end());
+
+    _results_front.store(front);
+}
+
+SSCMAResult SSCMA::snapshot()
+{
+    for (;;)
+    {
+        int8_t front = _results_front.load();
+        if (front < 0)
+        {
+            return SSCMAResult();
+        }
+        // pin, then check the decoder did not start refilling it in between
+        _results[front].refs.fetch_add(1);
+        if (_results_front.load() == front)
+        {
+            return SSCMAResult(&_results[front].result, &_results[front].refs);
+        }
+        _results[front].refs.fetch_sub(1);
+    }
+}
+
+SSCMAResult::SSCMAResult(const SSCMAResult &other) : _result(other._result), _refs(other._refs)
+{
+    if (_refs)
+    {
+        _refs->fetch_add(1);
+    }
+}
+
+SSCMAResult &SSCMAResult::operator=(const SSCMAResult &other)
+{
+    if (this != &other)
+    {
+        if (other._refs)
+        {
+            other._refs->fetch_add(1);
+        }
+        release();
+        _result = other._result;
+        _refs = other._refs;
+    }
+    return *this;
+}
+
+void SSCMAResult::release()
+{
+    if (_refs)
+    {
+        _refs->fetch_sub(1);
+    }
+    _result = NULL;
+    _refs = NULL;
+}
+
 bool SSCMA::set_rx_buffer(uint32_t size)
 {
     if (size == 0)
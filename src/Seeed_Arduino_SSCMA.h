@@ -42,6 +42,30 @@
 #define SSCMA_SPI_CLOCK 15000000
 #endif
 
+#ifndef SSCMA_RESET_PULSE
+#define SSCMA_RESET_PULSE 50 // ms
+#endif
+#ifndef SSCMA_READY_TIMEOUT
+#define SSCMA_READY_TIMEOUT 3000 // ms
+#endif
+
+// dedicated I/O task owning the transport, started at run time with start_io_task(); it needs std::thread,
+// so it is decided by the platform alone and every translation unit sees the same layout of SSCMA
+#if defined(ARDUINO_ARCH_ESP32) || !defined(ARDUINO)
+#define SSCMA_HAS_IO_TASK 1
+#else
+#define SSCMA_HAS_IO_TASK 0
+#endif
+#ifndef SSCMA_IO_TASK_STACK
+#define SSCMA_IO_TASK_STACK 8 * 1024
+#endif
+#ifndef SSCMA_MAILBOX_SIZE
+#define SSCMA_MAILBOX_SIZE 8
+#endif
+#ifndef SSCMA_RESULT_BUFFERS
+#define SSCMA_RESULT_BUFFERS 3 // published frames, one more than concurrently held handles
+#endif
+
 #ifndef SSCMA_MAX_RX_SIZE
 #ifdef ARDUINO_ARCH_ESP32
 #define SSCMA_MAX_RX_SIZE 32 * 1024
@@ -61,6 +85,13 @@
 #include <vector>
 #include <functional>
 
+#include <atomic>
+#if SSCMA_HAS_IO_TASK
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
 #include <Arduino.h>
 #include <Wire.h>
 #include <SPI.h>
@@ -155,6 +186,7 @@ typedef struct
     uint16_t h;
     uint8_t score;
     uint8_t target;
+    uint32_t track_id; // stable across frames with a tracker set, 0 when untracked
 } boxes_t;
 
 typedef struct
@@ -185,6 +217,65 @@ typedef struct
     uint16_t postprocess;
 } perf_t;
 
+#define DELTA_ADDED 0
+#define DELTA_REMOVED 1
+#define DELTA_MOVED 2
+
+typedef struct
+{
+    uint8_t kind; // DELTA_ADDED, DELTA_REMOVED or DELTA_MOVED
+    boxes_t box;  // the current box, or the last one seen for DELTA_REMOVED
+} delta_t;
+
+typedef std::function<void(const std::vector<delta_t> &delta)> DeltaCallback;
+
+typedef struct
+{
+    uint8_t score;       // minimum score, 0 keeps every score
+    uint32_t targets[8]; // allowlist bitmap indexed by target, all clear keeps every target
+    uint16_t roi_x;      // region of interest the box or point center must lie in
+    uint16_t roi_y;
+    uint16_t roi_w; // 0 disables the region of interest
+    uint16_t roi_h;
+    uint16_t top_k; // keep only the k highest scores, 0 keeps everything
+} filter_t;
+
+typedef struct
+{
+    uint16_t frame; // index of the frame within the batch
+    boxes_t box;
+} batch_box_t;
+
+typedef struct
+{
+    batch_box_t *boxes; // caller provided, boxes of all frames back to back
+    uint32_t size;      // capacity of boxes
+    perf_t *perf;       // caller provided, one entry per frame, may be NULL
+    uint32_t count;     // boxes stored
+    uint32_t frames;    // frames collected
+    uint32_t dropped;   // boxes that did not fit
+} batch_t;
+
+typedef struct
+{
+    uint32_t frames;   // INVOKE events received
+    uint32_t elapsed;  // ms since the first INVOKE was sent
+    uint32_t idle;     // ms the device spent waiting for the next INVOKE
+    float fps;         // effective throughput
+    float idle_ratio;  // idle / elapsed
+} invoke_stats_t;
+
+typedef struct
+{
+    uint32_t seq;       // frame sequence number
+    uint32_t timestamp; // millis() when the frame was decoded
+    perf_t perf;
+    std::vector<boxes_t> boxes;
+    std::vector<classes_t> classes;
+    std::vector<point_t> points;
+    std::vector<keypoints_t> keypoints;
+} result_t;
+
 typedef struct
 {
     int status;
@@ -218,6 +309,82 @@ typedef struct
     int status;
 } mqtt_status_t;
 
+// key/value store for device info that survives a reboot
+class SSCMACache
+{
+public:
+    virtual ~SSCMACache() {}
+    virtual bool get(const char *key, String &value) = 0;
+    virtual bool set(const char *key, const String &value) = 0;
+};
+
+// one file per key under dir through stdio, which ESP32 routes to any mounted VFS (SPIFFS, LittleFS, SD);
+// other cores have no stdio files, implement SSCMACache on their filesystem there
+#if defined(ARDUINO_ARCH_ESP32) || !defined(ARDUINO)
+#define SSCMA_FILE_CACHE 1
+class SSCMAFileCache : public SSCMACache
+{
+public:
+    SSCMAFileCache(const char *dir);
+
+    bool get(const char *key, String &value) override;
+    bool set(const char *key, const String &value) override;
+
+private:
+    char _dir[64];
+};
+#endif
+
+// assigns track ids to the boxes of consecutive frames
+class SSCMATracker
+{
+public:
+    virtual ~SSCMATracker() {}
+    virtual void track(std::vector<boxes_t> &boxes) = 0;
+    virtual void track(std::vector<keypoints_t> &keypoints) = 0;
+};
+
+// ByteTrack (tracker/BYTETracker.h), box positions are left as detected
+class SSCMAByteTracker : public SSCMATracker
+{
+public:
+    SSCMAByteTracker(int frame_rate = 10, int track_buffer = 30);
+    ~SSCMAByteTracker();
+
+    void track(std::vector<boxes_t> &boxes) override;
+    void track(std::vector<keypoints_t> &keypoints) override;
+
+private:
+    SSCMAByteTracker(const SSCMAByteTracker &) = delete;
+    SSCMAByteTracker &operator=(const SSCMAByteTracker &) = delete;
+
+    struct state_t;
+    state_t *_state; // NULL if it could not be allocated
+};
+
+// read-only handle on a published frame, the frame is not reused while a handle holds it
+class SSCMAResult
+{
+public:
+    SSCMAResult() : _result(NULL), _refs(NULL) {}
+    SSCMAResult(const SSCMAResult &other);
+    SSCMAResult &operator=(const SSCMAResult &other);
+    ~SSCMAResult() { release(); }
+
+    bool valid() const { return _result != NULL; }
+    explicit operator bool() const { return valid(); }
+    const result_t &operator*() const { return *_result; }
+    const result_t *operator->() const { return _result; }
+    void release();
+
+private:
+    friend class SSCMA;
+    SSCMAResult(const result_t *result, std::atomic<uint32_t> *refs) : _result(result), _refs(refs) {}
+
+    const result_t *_result;
+    std::atomic<uint32_t> *_refs;
+};
+
 class SSCMA
 {
 private:
@@ -235,11 +402,19 @@ private:
     std::vector<classes_t> _classes;
     std::vector<point_t> _points;
     std::vector<keypoints_t> _keypoints;
+    filter_t _filter = {0};
+
+    DeltaCallback _delta_callback;
+    uint16_t _delta_tolerance = 0;
+    std::vector<boxes_t> _last_boxes;
+    std::vector<uint8_t> _last_matched;
+    std::vector<delta_t> _delta;
 
     char _name[32] = {0};
     char _ID[32] = {0};
 
     uint32_t rx_end = 0;
+    uint32_t _ready_time = 0;
 
 #if ARDUINOJSON_VERSION_MAJOR == 7
     JsonDocument response; // for json response
@@ -249,6 +424,62 @@ private:
 
     String _image = "";
     String _info = "";
+    String _models = "";
+    String _sensors = "";
+
+    SSCMACache *_cache = NULL;
+    SSCMATracker *_tracker = NULL;
+
+    uint32_t _frame_seq = 0;
+
+#if SSCMA_HAS_IO_TASK
+    enum
+    {
+        IO_FREE,
+        IO_CLAIMED,
+        IO_QUEUED,
+        IO_RUNNING,
+        IO_DONE,
+        IO_ABANDONED,
+    };
+
+    struct io_request_t
+    {
+        std::atomic<uint8_t> state;
+        uint32_t ticket;
+        std::function<int(SSCMA &)> op;
+        int ret;
+    };
+
+    io_request_t _mailbox[SSCMA_MAILBOX_SIZE];
+    std::atomic<uint32_t> _mailbox_ticket;
+    std::atomic<bool> _io_running;
+    std::thread _io_thread;
+    std::mutex _io_mutex; // only guards the completion wakeups
+    std::condition_variable _io_done;
+    ResponseCallback _io_callback;
+#endif
+
+    // the decoder fills a free buffer and swaps it to the front, readers pin the front with refs
+    struct result_buffer_t
+    {
+        std::atomic<uint32_t> refs;
+        result_t result;
+    };
+
+    result_buffer_t _results[SSCMA_RESULT_BUFFERS];
+    std::atomic<int8_t> _results_front; // -1 before the first frame
+    uint32_t _results_dropped = 0;
+
+    bool _pipeline = false;         // send the next INVOKE as soon as an INVOKE event arrives
+    bool _pipeline_pending = false; // an INVOKE has been sent but its reply is not consumed yet
+    char _pipeline_cmd[32] = {0};
+
+    uint32_t _invoke_frames = 0;
+    uint32_t _invoke_begin = 0;    // ms
+    uint32_t _invoke_event_us = 0; // arrival of the last INVOKE event
+    bool _invoke_idle = false;     // device is idle since _invoke_event_us
+    uint64_t _invoke_idle_us = 0;
 
     char *tx_buf; // for cmd
     uint32_t tx_len;
@@ -266,7 +497,13 @@ public:
                uint32_t wait_delay = 2);
     bool begin(SPIClass *spi, int32_t cs = -1, int32_t sync = -1, int32_t rst = -1,
                uint32_t baud = SSCMA_SPI_CLOCK, uint32_t wait_delay = 2);
+    // returns after the last of the `times` results, which the result accessors then hold
     int invoke(int times = 1, bool filter = 0, bool show = 0);
+    int invoke_batch(int n, batch_t &sink, bool filter = 0);
+    int invoke_pipelined(bool filter = 0, bool show = 0);
+    int invoke_pipeline_stop();
+    invoke_stats_t invoke_stats();
+    void invoke_stats_reset();
     int available();
     int read(char *data, int length);
     int write(const char *data, int length);
@@ -279,6 +516,17 @@ public:
     std::vector<point_t> &points() { return _points; }
     std::vector<keypoints_t> &keypoints() { return _keypoints; }
 
+    // result filters, applied by the decoder before results are stored
+    void filter_score(uint8_t score);
+    void filter_target(uint8_t target, bool allow = true);
+    void filter_roi(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void filter_top_k(uint16_t k);
+    void filter_clear();
+
+    // call back only when the boxes differ from the previous frame by more than tolerance pixels;
+    // boxes only, classes, points and keypoints are not compared
+    void on_boxes_change(DeltaCallback callback, uint16_t tolerance = 8);
+
     int WIFIVER(char *version);
 
     int WIFI(wifi_t &wifi);
@@ -290,6 +538,16 @@ public:
     char *ID(bool cache = true);
     char *name(bool cache = true);
     String info(bool cache = true);
+    String models(bool cache = true);
+    String sensors(bool cache = true);
+
+    // must be set before begin() to skip the device info queries on a warm boot
+    void set_cache(SSCMACache *cache) { _cache = cache; }
+
+    // boxes and keypoints of every decoded frame get track ids from tracker, NULL turns tracking off
+    void set_tracker(SSCMATracker *tracker) { _tracker = tracker; }
+
+    uint32_t ready_time() { return _ready_time; } // ms from reset until the device answered
 
     // actions
     int clean_actions();
@@ -297,6 +555,20 @@ public:
 
     String last_image() { return _image; }
 
+#if SSCMA_HAS_IO_TASK
+    // run the transport and parser on a dedicated task, with a callback it proxies raw replies instead
+    bool start_io_task(ResponseCallback callback = nullptr, uint32_t stack_size = SSCMA_IO_TASK_STACK);
+    void stop_io_task();
+    bool io_task_running() { return _io_running; }
+    // run op on the I/O task and wait for it, safe to call from any task
+    int submit(std::function<int(SSCMA &)> op, uint32_t timeout = 3000);
+#endif
+
+    // latest complete frame, never waits and never blocks the decoder, safe to call from any task
+    SSCMAResult snapshot();
+    // frames not published because every buffer was held by a reader
+    uint32_t snapshots_dropped() { return _results_dropped; }
+
     bool set_rx_buffer(uint32_t size);
     bool set_tx_buffer(uint32_t size);
 
@@ -311,7 +583,20 @@ private:
     int spi_available();
     void spi_cmd(uint8_t feature, uint8_t cmd, uint16_t len = 0, uint8_t *data = NULL);
 
+    bool handshake();
+    uint32_t version_hash();
+    bool cache_load(uint32_t hash);
+    void cache_store(uint32_t hash);
     int wait(int type, const char *cmd, uint32_t timeout = 1000);
+    void invoke_send(const char *cmd);
+    void invoke_event(bool pipeline);
+    bool filter_accept(uint8_t score, uint8_t target);
+    bool filter_accept(uint16_t x, uint16_t y, uint8_t score, uint8_t target);
+    void detect_change();
+#if SSCMA_HAS_IO_TASK
+    void io_loop();
+#endif
+    void publish();
     void praser_event();
     void praser_log();
 };
@@ -0,0 +1,242 @@
+/*
+ * MIT License
+ * Copyright (c) 2021 Yifu Zhang
+ *
+ * Modified by nullptr, Apr 15, 2024, Seeed Technology Co.,Ltd
+*/
+
+#include "BYTETracker.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+BYTETracker::BYTETracker(int frame_rate, int track_buffer) {
+    track_thresh = 0.5;
+    high_thresh  = 0.6;
+    match_thresh = 0.8;
+
+    frame_id      = 0;
+    max_time_lost = int(frame_rate / 30.0 * track_buffer);
+    track_count   = 0;
+
+    pool.reserve(BYTE_TRACKER_MAX_TRACKS);
+    pool_removed.reserve(BYTE_TRACKER_MAX_TRACKS);
+    pool_free.reserve(BYTE_TRACKER_MAX_TRACKS);
+    kalman_states.reserve(BYTE_TRACKER_MAX_TRACKS);
+    tracked_stracks.reserve(BYTE_TRACKER_MAX_TRACKS);
+    lost_stracks.reserve(BYTE_TRACKER_MAX_TRACKS);
+    output_stracks.reserve(BYTE_TRACKER_MAX_TRACKS);
+    matches.reserve(BYTE_TRACKER_MAX_TRACKS);
+    lap.reserve(BYTE_TRACKER_MAX_TRACKS, BYTE_TRACKER_MAX_TRACKS);
+}
+
+BYTETracker::~BYTETracker() {}
+
+const vector<STrack>& BYTETracker::update(const vector<Object>& objects) {
+    ////////////////// Step 1: Get detections //////////////////
+    this->frame_id += 1;
+
+    detections.clear();
+    detections_low.clear();
+    detections_cp.clear();
+    activated_stracks.clear();
+    refind_stracks.clear();
+    new_lost_stracks.clear();
+    new_removed_stracks.clear();
+    unconfirmed.clear();
+    strack_pool.clear();
+    r_tracked_stracks.clear();
+    output_stracks.clear();
+
+    for (int i = 0; i < static_cast<int>(objects.size()); ++i) {
+        const Object& obj = objects[i];
+        float         tlwh_[4];
+
+        tlwh_[0] = obj.rect.x;
+        tlwh_[1] = obj.rect.y;
+        tlwh_[2] = obj.rect.width;
+        tlwh_[3] = obj.rect.height;
+
+        float score = obj.prob;
+        if (score >= track_thresh) {
+            detections.emplace_back(tlwh_, score, obj.label, i);
+        } else {
+            detections_low.emplace_back(tlwh_, score, obj.label, i);
+        }
+    }
+
+    // Add newly detected tracklets to tracked_stracks
+    for (int i : this->tracked_stracks) {
+        if (!pool[i].is_activated)
+            unconfirmed.push_back(i);
+        else
+            strack_pool.push_back(i);
+    }
+
+    ////////////////// Step 2: First association, with IoU //////////////////
+    joint_stracks(strack_pool, this->lost_stracks);
+    to_pointers(atracks, pool, strack_pool);
+    STrack::multi_predict(atracks, this->kalman_states, this->kalman_filter);
+
+    int dist_size = 0, dist_size_size = 0;
+    to_pointers(btracks, detections);
+    iou_distance(atracks, btracks, dist_size, dist_size_size);
+
+    matches.clear();
+    u_track.clear();
+    u_detection.clear();
+    linear_assignment(dists.data(), dist_size, dist_size_size, match_thresh, matches, u_track, u_detection);
+
+    for (const pair<int, int>& match : matches) {
+        int     idx   = strack_pool[match.first];
+        STrack* track = &pool[idx];
+        STrack* det   = &detections[match.second];
+        if (track->state == TrackState::Tracked) {
+            track->update(this->kalman_filter, this->kalman_states, *det, this->frame_id);
+            activated_stracks.push_back(idx);
+        } else {
+            track->re_activate(this->kalman_filter, this->kalman_states, *det, this->frame_id);
+            refind_stracks.push_back(idx);
+        }
+    }
+
+    ////////////////// Step 3: Second association, using low score dets //////////////////
+    for (size_t i = 0; i < u_detection.size(); ++i) {
+        detections_cp.push_back(detections[u_detection[i]]);
+    }
+
+    for (size_t i = 0; i < u_track.size(); ++i) {
+        int idx = strack_pool[u_track[i]];
+        if (pool[idx].state == TrackState::Tracked) {
+            r_tracked_stracks.push_back(idx);
+        }
+    }
+
+    to_pointers(atracks, pool, r_tracked_stracks);
+    to_pointers(btracks, detections_low);
+    iou_distance(atracks, btracks, dist_size, dist_size_size);
+
+    matches.clear();
+    u_track.clear();
+    u_detection.clear();
+    linear_assignment(dists.data(), dist_size, dist_size_size, 0.5, matches, u_track, u_detection);
+
+    for (const pair<int, int>& match : matches) {
+        int     idx   = r_tracked_stracks[match.first];
+        STrack* track = &pool[idx];
+        STrack* det   = &detections_low[match.second];
+        if (track->state == TrackState::Tracked) {
+            track->update(this->kalman_filter, this->kalman_states, *det, this->frame_id);
+            activated_stracks.push_back(idx);
+        } else {
+            track->re_activate(this->kalman_filter, this->kalman_states, *det, this->frame_id);
+            refind_stracks.push_back(idx);
+        }
+    }
+
+    for (size_t i = 0; i < u_track.size(); ++i) {
+        int idx = r_tracked_stracks[u_track[i]];
+        if (pool[idx].state != TrackState::Lost) {
+            pool[idx].mark_lost();
+            new_lost_stracks.push_back(idx);
+        }
+    }
+
+    // Deal with unconfirmed tracks, usually tracks with only one beginning frame
+    to_pointers(atracks, pool, unconfirmed);
+    to_pointers(btracks, detections_cp);
+    iou_distance(atracks, btracks, dist_size, dist_size_size);
+
+    matches.clear();
+    u_unconfirmed.clear();
+    u_detection.clear();
+    linear_assignment(dists.data(), dist_size, dist_size_size, 0.7, matches, u_unconfirmed, u_detection);
+
+    for (const pair<int, int>& match : matches) {
+        int idx = unconfirmed[match.first];
+        pool[idx].update(this->kalman_filter, this->kalman_states, detections_cp[match.second], this->frame_id);
+        activated_stracks.push_back(idx);
+    }
+
+    for (size_t i = 0; i < u_unconfirmed.size(); ++i) {
+        int idx = unconfirmed[u_unconfirmed[i]];
+        pool[idx].mark_removed();
+        new_removed_stracks.push_back(idx);
+    }
+
+    ////////////////// Step 4: Init new stracks //////////////////
+    // alloc_track() may grow the pool, only indices are held from here on
+    for (size_t i = 0; i < u_detection.size(); ++i) {
+        const STrack& track = detections_cp[u_detection[i]];
+        if (track.score < this->high_thresh) continue;
+        int idx = alloc_track(track);
+        if (idx < 0) break;
+        pool[idx].activate(this->kalman_filter, this->kalman_states, this->frame_id, ++this->track_count);
+        activated_stracks.push_back(idx);
+    }
+
+    ////////////////// Step 5: Update state //////////////////
+    for (int i : this->lost_stracks) {
+        if (this->frame_id - pool[i].end_frame() > this->max_time_lost) {
+            pool[i].mark_removed();
+            new_removed_stracks.push_back(i);
+        }
+    }
+
+    tracked_stracks_swap.clear();
+    for (int i : this->tracked_stracks) {
+        if (pool[i].state == TrackState::Tracked) {
+            tracked_stracks_swap.push_back(i);
+        }
+    }
+    this->tracked_stracks.swap(tracked_stracks_swap);
+
+    joint_stracks(this->tracked_stracks, activated_stracks);
+    joint_stracks(this->tracked_stracks, refind_stracks);
+
+    sub_stracks(this->lost_stracks, this->tracked_stracks);
+    for (int i : new_lost_stracks) {
+        this->lost_stracks.push_back(i);
+    }
+
+    // tracks removed in an earlier frame leave the lost list now, the ones removed in this
+    // frame stay in it for one more frame
+    size_t kept = 0;
+    for (int i : this->lost_stracks) {
+        if (!pool_removed[i]) {
+            this->lost_stracks[kept++] = i;
+        }
+    }
+    this->lost_stracks.resize(kept);
+    sort_stracks(this->lost_stracks);
+    for (int i : new_removed_stracks) {
+        pool_removed[i] = 1;
+    }
+
+    remove_duplicate_stracks(this->tracked_stracks, this->lost_stracks);
+
+    // entries in neither list are free for the next frame
+    in_list.assign(pool.size(), 0);
+    for (int i : this->tracked_stracks) {
+        in_list[i] = 1;
+    }
+    for (int i : this->lost_stracks) {
+        in_list[i] = 1;
+    }
+    pool_free.clear();
+    for (int i = 0; i < static_cast<int>(pool.size()); ++i) {
+        if (!in_list[i]) {
+            pool_free.push_back(i);
+        }
+    }
+
+    for (int i : this->tracked_stracks) {
+        if (pool[i].is_activated) {
+            output_stracks.push_back(pool[i]);
+        }
+    }
+    return output_stracks;
+}
@@ -0,0 +1,127 @@
+/*
+ * MIT License
+ * Copyright (c) 2021 Yifu Zhang
+ *
+ * Modified by nullptr, Apr 15, 2024, Seeed Technology Co.,Ltd
+*/
+
+#pragma once
+
+#include <cfloat>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "STrack.h"
+#include "lapjv.h"
+
+class BYTETracker {
+   public:
+    struct Object {
+        Rect4f rect;
+        int    label;
+        float  prob;
+    };
+
+   public:
+    BYTETracker(int frame_rate = 10, int track_buffer = 30);
+    ~BYTETracker();
+
+    // activated tracks of this frame, valid until the next update(); every one was matched with
+    // objects[track.object] in this frame
+    const std::vector<STrack>& update(const std::vector<Object>& objects);
+
+   private:
+    friend struct BYTETrackerBench;  // extras/tracker, times the private stages on the host
+
+    static void to_pointers(std::vector<STrack*>&   res,
+                            std::vector<STrack>&    stracks,
+                            const std::vector<int>& indices);
+    static void to_pointers(std::vector<STrack*>& res, std::vector<STrack>& stracks);
+
+    // pool entry holding a copy of track, -1 with BYTE_TRACKER_MAX_TRACKS tracks alive
+    int  alloc_track(const STrack& track);
+    void joint_stracks(std::vector<int>& tlista, const std::vector<int>& tlistb);
+    void sub_stracks(std::vector<int>& tlista, const std::vector<int>& tlistb);
+    void sort_stracks(std::vector<int>& tlist);
+    void remove_duplicate_stracks(std::vector<int>& stracksa, std::vector<int>& stracksb);
+
+    // matches are (row, col) pairs; returns 0, or -1 if LapJV failed on non-finite costs, whose rows and
+    // columns are then left unmatched, which is all update() needs
+    int linear_assignment(const track_real_t*                cost_matrix,
+                          int                                cost_matrix_size,
+                          int                                cost_matrix_size_size,
+                          track_real_t                       thresh,
+                          std::vector<std::pair<int, int> >& matches,
+                          std::vector<int>&                  unmatched_a,
+                          std::vector<int>&                  unmatched_b);
+    // fills dists with 1 - iou, row major, one row per track of atracks; 1 across labels (BYTE_TRACKER_CLASS_AWARE)
+    void iou_distance(const std::vector<STrack*>& atracks,
+                      const std::vector<STrack*>& btracks,
+                      int&                        dist_size,
+                      int&                        dist_size_size);
+
+    int assign(const track_real_t* cost, int rows, int cols, track_real_t thresh);
+    // pairs costing cost_limit or more are left unmatched (-1); returns 0, or -1 with nothing matched if
+    // LapJV failed
+    int lapjv(const track_real_t* cost,
+              int                 n_rows,
+              int                 n_cols,
+              track_real_t        cost_limit,
+              std::vector<int>&   rowsol,
+              std::vector<int>&   colsol);
+
+   private:
+    float        track_thresh;
+    float        high_thresh;
+    track_real_t match_thresh;
+    int          frame_id;
+    int          max_time_lost;
+    int          track_count;  // last track id handed out
+
+    // every live track sits in one pool entry, the lists below hold pool indices
+    std::vector<STrack>       pool;
+    std::vector<uint8_t>      pool_removed;  // removed at least once, dropped the next time it is lost
+    std::vector<int>          pool_free;
+    byte_kalman::KalmanStates kalman_states;  // entry i is the filter state of pool[i]
+
+    std::vector<int>          tracked_stracks;
+    std::vector<int>          lost_stracks;
+    byte_kalman::KalmanFilter kalman_filter;
+
+    // per-frame scratch, kept to reuse its capacity
+    std::vector<STrack>               detections;
+    std::vector<STrack>               detections_low;
+    std::vector<STrack>               detections_cp;
+    std::vector<int>                  activated_stracks;
+    std::vector<int>                  refind_stracks;
+    std::vector<int>                  new_lost_stracks;
+    std::vector<int>                  new_removed_stracks;
+    std::vector<int>                  unconfirmed;
+    std::vector<int>                  strack_pool;
+    std::vector<int>                  r_tracked_stracks;
+    std::vector<int>                  tracked_stracks_swap;
+    std::vector<STrack*>              atracks;
+    std::vector<STrack*>              btracks;
+    std::vector<std::pair<int, int> > matches;
+    std::vector<int>                  u_track;
+    std::vector<int>                  u_detection;
+    std::vector<int>                  u_unconfirmed;
+    std::vector<uint8_t>              in_list;
+    std::vector<uint8_t>              dup_a;
+    std::vector<uint8_t>              dup_b;
+    std::vector<track_real_t>         boxes_a; // x1, y1, x2, y2 planes of atracks
+    std::vector<track_real_t>         boxes_b;
+    std::vector<track_real_t>         dists;
+    std::vector<int>                  labels_b;
+    LapJV                             lap;
+    std::vector<track_real_t>         lap_cost;
+    std::vector<track_real_t>         lap_sub;
+    std::vector<int>                  lap_parent;
+    std::vector<int>                  lap_nodes;
+    std::vector<int>                  sub_rowsol;
+    std::vector<int>                  sub_colsol;
+    std::vector<int>                  rowsol;
+    std::vector<int>                  colsol;
+    std::vector<STrack>               output_stracks;
+};
@@ -0,0 +1,158 @@
+/*
+ * MIT License
+ * Copyright (c) 2021 Yifu Zhang
+ *
+ * Modified by nullptr, Apr 15, 2024, Seeed Technology Co.,Ltd
+*/
+
+#include "STrack.h"
+
+#include <algorithm>
+
+using namespace std;
+
+STrack::STrack(const float tlwh_[4], float score, int label, int object) {
+    for (int i = 0; i < 4; i++) {
+        _tlwh[i] = tlwh_[i];
+    }
+
+    is_activated = false;
+    track_id     = 0;
+    state        = TrackState::New;
+    slot         = -1;
+
+    for (int i = 0; i < 4; i++) {
+        tlwh[i] = _tlwh[i];
+    }
+    static_tlbr();
+
+    frame_id     = 0;
+    tracklet_len = 0;
+    this->score  = score;
+    start_frame  = 0;
+
+    this->label  = label;
+    this->object = object;
+}
+
+void STrack::activate(const byte_kalman::KalmanFilter& kalman_filter,
+                      byte_kalman::KalmanStates&       states,
+                      int                              frame_id,
+                      int                              track_id) {
+    this->track_id = track_id;
+
+    track_real_t xyah[4];
+    tlwh_to_xyah(this->_tlwh, xyah);
+    kalman_filter.initiate(xyah, states.mean(slot), states.covariance(slot), states.stride());
+
+    static_tlwh(states);
+    static_tlbr();
+
+    this->tracklet_len = 0;
+    this->state        = TrackState::Tracked;
+    if (frame_id == 1) {
+        this->is_activated = true;
+    }
+    this->frame_id    = frame_id;
+    this->start_frame = frame_id;
+}
+
+void STrack::re_activate(const byte_kalman::KalmanFilter& kalman_filter,
+                         byte_kalman::KalmanStates&       states,
+                         const STrack&                    new_track,
+                         int                              frame_id,
+                         int                              new_track_id) {
+    track_real_t xyah[4];
+    tlwh_to_xyah(new_track.tlwh, xyah);
+    kalman_filter.update(states.mean(slot), states.covariance(slot), states.stride(), xyah);
+
+    static_tlwh(states);
+    static_tlbr();
+
+    this->tracklet_len = 0;
+    this->state        = TrackState::Tracked;
+    this->is_activated = true;
+    this->frame_id     = frame_id;
+    this->score        = new_track.score;
+    this->object       = new_track.object;
+    if (new_track_id) this->track_id = new_track_id;
+}
+
+void STrack::update(const byte_kalman::KalmanFilter& kalman_filter,
+                    byte_kalman::KalmanStates&       states,
+                    const STrack&                    new_track,
+                    int                              frame_id) {
+    this->frame_id = frame_id;
+    this->tracklet_len++;
+
+    track_real_t xyah[4];
+    tlwh_to_xyah(new_track.tlwh, xyah);
+    kalman_filter.update(states.mean(slot), states.covariance(slot), states.stride(), xyah);
+
+    static_tlwh(states);
+    static_tlbr();
+
+    this->state        = TrackState::Tracked;
+    this->is_activated = true;
+
+    this->score  = new_track.score;
+    this->object = new_track.object;
+}
+
+void STrack::static_tlwh(const byte_kalman::KalmanStates& states) {
+    if (this->state == TrackState::New) {
+        tlwh[0] = _tlwh[0];
+        tlwh[1] = _tlwh[1];
+        tlwh[2] = _tlwh[2];
+        tlwh[3] = _tlwh[3];
+        return;
+    }
+
+    const track_real_t* mean   = states.mean(slot);
+    int                 stride = states.stride();
+
+    tlwh[0] = mean[0];
+    tlwh[1] = mean[stride];
+    tlwh[2] = mean[2 * stride];
+    tlwh[3] = mean[3 * stride];
+
+    tlwh[2] *= tlwh[3];
+    tlwh[0] -= tlwh[2] / 2;
+    tlwh[1] -= tlwh[3] / 2;
+}
+
+void STrack::static_tlbr() {
+    tlbr[0] = tlwh[0];
+    tlbr[1] = tlwh[1];
+    tlbr[2] = tlwh[2] + tlbr[0];
+    tlbr[3] = tlwh[3] + tlbr[1];
+}
+
+void STrack::tlwh_to_xyah(const track_real_t tlwh_tmp[4], track_real_t xyah[4]) {
+    xyah[0] = tlwh_tmp[0] + tlwh_tmp[2] / 2;
+    xyah[1] = tlwh_tmp[1] + tlwh_tmp[3] / 2;
+    xyah[2] = tlwh_tmp[2] / tlwh_tmp[3];
+    xyah[3] = tlwh_tmp[3];
+}
+
+void STrack::mark_lost() { state = TrackState::Lost; }
+
+void STrack::mark_removed() { state = TrackState::Removed; }
+
+int STrack::end_frame() { return this->frame_id; }
+
+void STrack::multi_predict(vector<STrack*>&                 stracks,
+                           byte_kalman::KalmanStates&       states,
+                           const byte_kalman::KalmanFilter& kalman_filter) {
+    fill(states.mask.begin(), states.mask.end(), 0);
+    for (STrack* strack : stracks) {
+        states.mask[strack->slot] = strack->state == TrackState::Tracked ? KAL_PREDICT_TRACKED : KAL_PREDICT;
+    }
+
+    kalman_filter.multi_predict(states);
+
+    for (STrack* strack : stracks) {
+        strack->static_tlwh(states);
+        strack->static_tlbr();
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ * Copyright (c) 2021 Yifu Zhang
+ *
+ * Modified by nullptr, Apr 15, 2024, Seeed Technology Co.,Ltd
+*/
+
+#pragma once
+
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "kalmanFilter.h"
+
+enum TrackState { New = 0, Tracked, Lost, Removed };
+
+// plain track record, copies are memcpy and never allocate
+// the kalman filter and the filter states of all tracks are owned by BYTETracker
+class STrack {
+   public:
+    STrack() = default;
+    STrack(const float tlwh_[4], float score, int label, int object = -1);
+
+    void static tlwh_to_xyah(const track_real_t tlwh_tmp[4], track_real_t xyah[4]);
+    void static multi_predict(std::vector<STrack*>&            stracks,
+                              byte_kalman::KalmanStates&       states,
+                              const byte_kalman::KalmanFilter& kalman_filter);
+    void        static_tlwh(const byte_kalman::KalmanStates& states);
+    void        static_tlbr();
+    void        mark_lost();
+    void        mark_removed();
+    int         end_frame();
+
+    // the track's filter state is entry slot of states, set before activating
+    void activate(const byte_kalman::KalmanFilter& kalman_filter,
+                  byte_kalman::KalmanStates&       states,
+                  int                              frame_id,
+                  int                              track_id);
+    void re_activate(const byte_kalman::KalmanFilter& kalman_filter,
+                     byte_kalman::KalmanStates&       states,
+                     const STrack&                    new_track,
+                     int                              frame_id,
+                     int                              new_track_id = 0);
+    void update(const byte_kalman::KalmanFilter& kalman_filter,
+                byte_kalman::KalmanStates&       states,
+                const STrack&                    new_track,
+                int                              frame_id);
+
+   public:
+    bool is_activated;
+    int  track_id;
+    int  state;
+
+    track_real_t _tlwh[4];
+    track_real_t tlwh[4];
+    track_real_t tlbr[4];
+
+    int frame_id;
+    int tracklet_len;
+    int start_frame;
+
+    int   slot;  // index of the filter state in byte_kalman::KalmanStates, -1 for detections
+    float score;
+
+    int label;
+    int object;  // index into the objects of the last update() the track was matched with
+};
+
+static_assert(std::is_trivially_copyable<STrack>::value, "STrack must stay trivially copyable");
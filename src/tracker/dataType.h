@@ -0,0 +1,65 @@
+/*
+ * MIT License
+ * Copyright (c) 2021 Yifu Zhang
+ *
+ * Modified by nullptr, Apr 15, 2024, Seeed Technology Co.,Ltd
+*/
+
+#pragma once
+
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Tracker arithmetic: float, or Q16.16 fixed point (fixedPoint.h) where float is done in software, the ESP32-C3,
+// C6 and S2 for instance. Define BYTE_TRACKER_FIXED_POINT to 0 or 1 to choose by hand.
+#ifndef BYTE_TRACKER_FIXED_POINT
+    #if (defined(__riscv) && !defined(__riscv_flen)) || defined(__XTENSA_SOFT_FLOAT__)
+        #define BYTE_TRACKER_FIXED_POINT 1
+    #else
+        #define BYTE_TRACKER_FIXED_POINT 0
+    #endif
+#endif
+
+#if BYTE_TRACKER_FIXED_POINT
+    #include "fixedPoint.h"
+typedef q16_t track_real_t;
+#else
+typedef float track_real_t;
+#endif
+
+// Most live (tracked or lost) tracks, their states are allocated up front. Past it no new tracks are started
+// until an old one is dropped.
+#ifndef BYTE_TRACKER_MAX_TRACKS
+    #define BYTE_TRACKER_MAX_TRACKS 64
+#endif
+
+// Tracks only match detections of their own label, set to 0 to associate across labels.
+#ifndef BYTE_TRACKER_CLASS_AWARE
+    #define BYTE_TRACKER_CLASS_AWARE 1
+#endif
+
+// packed kalman covariance, see byte_kalman::KalmanFilter
+#define KAL_PP        0
+#define KAL_PV        4
+#define KAL_VV        8
+#define KAL_COVA_SIZE 12
+
+#define KAL_PREDICT         1
+#define KAL_PREDICT_TRACKED 2
+
+struct Rect4f {
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+struct Scalar3u {
+    Scalar3u(unsigned int v1, unsigned int v2, unsigned int v3) : val1(v1), val2(v2), val3(v3) {}
+
+    unsigned int val1;
+    unsigned int val2;
+    unsigned int val3;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// Q16.16 fixed point for the tracker on targets without an FPU. Sums, products and quotients are done in 64 bits
+// and saturate instead of wrapping, so a diverging covariance pins at the range limit rather than turning
+// negative. Converting in from float, double or int is implicit (constants fold at compile time), converting out
+// is explicit and truncates toward zero like a float to int cast.
+class q16_t {
+   public:
+    static constexpr int     FRAC_BITS = 16;
+    static constexpr int32_t ONE       = 1 << FRAC_BITS;
+
+    int32_t raw;
+
+    constexpr q16_t() : raw(0) {}
+    constexpr q16_t(int v) : raw(saturate(static_cast<int64_t>(v) * ONE)) {}
+    constexpr q16_t(double v) : raw(saturate(static_cast<int64_t>(v * ONE + (v < 0 ? -0.5 : 0.5)))) {}
+    constexpr q16_t(float v) : q16_t(static_cast<double>(v)) {}
+
+    static constexpr q16_t from_raw(int32_t raw) {
+        q16_t v;
+        v.raw = raw;
+        return v;
+    }
+    static constexpr q16_t max() { return from_raw(INT32_MAX); }
+    static constexpr q16_t lowest() { return from_raw(INT32_MIN + 1); }
+
+    template <typename T> explicit constexpr operator T() const {
+        static_assert(std::is_arithmetic<T>::value, "q16_t converts to arithmetic types only");
+        return std::is_floating_point<T>::value ? static_cast<T>(raw / static_cast<double>(ONE))
+                                                : static_cast<T>(raw / ONE);
+    }
+
+    constexpr q16_t operator-() const { return from_raw(saturate(-static_cast<int64_t>(raw))); }
+
+    friend constexpr q16_t operator+(q16_t a, q16_t b) {
+        return from_raw(saturate(static_cast<int64_t>(a.raw) + b.raw));
+    }
+    friend constexpr q16_t operator-(q16_t a, q16_t b) {
+        return from_raw(saturate(static_cast<int64_t>(a.raw) - b.raw));
+    }
+    friend constexpr q16_t operator*(q16_t a, q16_t b) {
+        return from_raw(saturate((static_cast<int64_t>(a.raw) * b.raw) >> FRAC_BITS));
+    }
+    friend constexpr q16_t operator/(q16_t a, q16_t b) {
+        return b.raw == 0 ? (a.raw < 0 ? lowest() : max())
+                          : from_raw(saturate(static_cast<int64_t>(a.raw) * ONE / b.raw));
+    }
+
+    q16_t& operator+=(q16_t b) { return *this = *this + b; }
+    q16_t& operator-=(q16_t b) { return *this = *this - b; }
+    q16_t& operator*=(q16_t b) { return *this = *this * b; }
+    q16_t& operator/=(q16_t b) { return *this = *this / b; }
+
+    friend constexpr bool operator==(q16_t a, q16_t b) { return a.raw == b.raw; }
+    friend constexpr bool operator!=(q16_t a, q16_t b) { return a.raw != b.raw; }
+    friend constexpr bool operator<(q16_t a, q16_t b) { return a.raw < b.raw; }
+    friend constexpr bool operator>(q16_t a, q16_t b) { return a.raw > b.raw; }
+    friend constexpr bool operator<=(q16_t a, q16_t b) { return a.raw <= b.raw; }
+    friend constexpr bool operator>=(q16_t a, q16_t b) { return a.raw >= b.raw; }
+
+   private:
+    static constexpr int32_t saturate(int64_t v) {
+        return v > INT32_MAX ? INT32_MAX : v < INT32_MIN + 1 ? INT32_MIN + 1 : static_cast<int32_t>(v);
+    }
+};
+
+// square root by bits, negative inputs give 0
+inline q16_t sqrt(q16_t v) {
+    if (v.raw <= 0) return q16_t();
+    uint64_t x = static_cast<uint64_t>(v.raw) << q16_t::FRAC_BITS;
+    uint64_t r = 0;
+    uint64_t b = uint64_t(1) << 62;
+    while (b > x) b >>= 2;
+    while (b) {
+        if (x >= r + b) {
+            x -= r + b;
+            r = (r >> 1) + b;
+        } else {
+            r >>= 1;
+        }
+        b >>= 2;
+    }
+    return q16_t::from_raw(static_cast<int32_t>(r));
+}
+
+namespace std {
+template <> class numeric_limits<q16_t> {
+   public:
+    static constexpr bool  is_specialized = true;
+    static constexpr bool  has_infinity   = false;
+    static constexpr q16_t max() { return q16_t::max(); }
+    static constexpr q16_t lowest() { return q16_t::lowest(); }
+    static constexpr q16_t infinity() { return q16_t::max(); }
+};
+}  // namespace std
@@ -0,0 +1,215 @@
+/*
+ * MIT License
+ * Copyright (c) 2021 Yifu Zhang
+ *
+ * Modified by nullptr, Apr 15, 2024, Seeed Technology Co.,Ltd
+*/
+#include "kalmanFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace byte_kalman {
+
+const double KalmanFilter::chi2inv95[10] = {0, 3.8415, 5.9915, 7.8147, 9.4877, 11.070, 12.592, 14.067, 15.507, 16.919};
+
+// noise variance of a standard deviation; in Q16.16 the aspect ratio's 1e-5 squares to 0, which would leave that
+// state without noise, so it is kept at the smallest step above 0 there (1.5e-5 instead of 1e-10)
+static inline track_real_t variance(track_real_t std) {
+#if BYTE_TRACKER_FIXED_POINT
+    return std::max(std * std, q16_t::from_raw(1));
+#else
+    return std * std;
+#endif
+}
+
+KalmanStates::KalmanStates() : n(0), capacity(0) {}
+
+void KalmanStates::resize(int n) {
+    if (n > capacity) {
+        reserve(std::max(n, std::max(capacity * 2, 8)));
+    }
+    this->n = n;
+    mask.resize(n);
+}
+
+void KalmanStates::reserve(int n) {
+    if (n <= capacity) {
+        return;
+    }
+
+    std::vector<track_real_t> new_means(8 * n);
+    std::vector<track_real_t> new_covariances(KAL_COVA_SIZE * n);
+    for (int k = 0; k < 8; k++) {
+        std::copy_n(means.data() + k * capacity, this->n, new_means.data() + k * n);
+    }
+    for (int k = 0; k < KAL_COVA_SIZE; k++) {
+        std::copy_n(covariances.data() + k * capacity, this->n, new_covariances.data() + k * n);
+    }
+    means.swap(new_means);
+    covariances.swap(new_covariances);
+    mask.reserve(n);
+    capacity = n;
+}
+
+KalmanFilter::KalmanFilter() {
+    this->_dt                  = 1.;
+    this->_std_weight_position = 1. / 20;
+    this->_std_weight_velocity = 1. / 160;
+}
+
+void KalmanFilter::initiate(const track_real_t measurement[4], track_real_t* mean, track_real_t* covariance, int stride) const {
+    track_real_t std_pos[4], std_vel[4];
+    std_pos[0] = 2 * _std_weight_position * measurement[3];
+    std_pos[1] = 2 * _std_weight_position * measurement[3];
+    std_pos[2] = 1e-2;
+    std_pos[3] = 2 * _std_weight_position * measurement[3];
+    std_vel[0] = 10 * _std_weight_velocity * measurement[3];
+    std_vel[1] = 10 * _std_weight_velocity * measurement[3];
+    std_vel[2] = 1e-5;
+    std_vel[3] = 10 * _std_weight_velocity * measurement[3];
+
+    for (int i = 0; i < 4; i++) {
+        mean[i * stride]                  = measurement[i];
+        mean[(i + 4) * stride]            = 0;
+        covariance[(KAL_PP + i) * stride] = variance(std_pos[i]);
+        covariance[(KAL_PV + i) * stride] = 0;
+        covariance[(KAL_VV + i) * stride] = variance(std_vel[i]);
+    }
+}
+
+// one coordinate's 2x2 block of n tracks: F P F' + Q with F = [1 dt; 0 1] and noise standard deviations
+// w_pos * h + c_pos and w_vel * h + c_vel, one of w and c being 0
+static void predict_block(track_real_t* __restrict pp,
+                          track_real_t* __restrict pv,
+                          track_real_t* __restrict vv,
+                          const track_real_t* __restrict h,
+                          int                            n,
+                          track_real_t                   dt,
+                          track_real_t                   w_pos,
+                          track_real_t                   c_pos,
+                          track_real_t                   w_vel,
+                          track_real_t                   c_vel) {
+    for (int t = 0; t < n; t++) {
+        track_real_t std_pos = w_pos * h[t] + c_pos;
+        track_real_t std_vel = w_vel * h[t] + c_vel;
+        track_real_t pv1     = pv[t] + dt * vv[t];
+        pp[t]                = ((pp[t] + dt * pv[t]) + dt * pv1) + variance(std_pos);
+        pv[t]                = pv1;
+        vv[t]                = vv[t] + variance(std_vel);
+    }
+}
+
+static void predict_position(track_real_t* __restrict pos, const track_real_t* __restrict vel, int n, track_real_t dt) {
+    for (int t = 0; t < n; t++) {
+        pos[t] += dt * vel[t];
+    }
+}
+
+void KalmanFilter::multi_predict(KalmanStates& states) const {
+    const int      n      = states.size();
+    const int      stride = states.stride();
+    const uint8_t* mask   = states.mask.data();
+    track_real_t*  mean   = states.mean(0);
+    track_real_t*  cov    = states.covariance(0);
+
+    // every track is predicted in straight, vectorizable passes, so the few that have to stay as they are
+    // (unconfirmed or unused ones) are set aside and put back afterwards
+    states.held.clear();
+    states.held_values.clear();
+    for (int t = 0; t < n; t++) {
+        if (mask[t]) continue;
+        states.held.push_back(t);
+        for (int k = 0; k < 8; k++) states.held_values.push_back(mean[k * stride + t]);
+        for (int k = 0; k < KAL_COVA_SIZE; k++) states.held_values.push_back(cov[k * stride + t]);
+    }
+
+    // the h velocity of tracks not in the Tracked state is reset, and that of tracked ones set to 1, before
+    // predicting; it is how this port has always behaved, kept so tracks come out the same
+    track_real_t* vh = mean + 7 * stride;
+    for (int t = 0; t < n; t++) {
+        if (mask[t]) vh[t] = mask[t] == KAL_PREDICT_TRACKED;
+    }
+
+    // the noise depends on the h before predicting, so the covariance goes first
+    const track_real_t* h = mean + 3 * stride;
+    for (int i = 0; i < 4; i++) {
+        track_real_t* pp = cov + (KAL_PP + i) * stride;
+        track_real_t* pv = cov + (KAL_PV + i) * stride;
+        track_real_t* vv = cov + (KAL_VV + i) * stride;
+        if (i == 2) {
+            predict_block(pp, pv, vv, h, n, _dt, 0, 1e-2, 0, 1e-5);
+        } else {
+            predict_block(pp, pv, vv, h, n, _dt, _std_weight_position, 0, _std_weight_velocity, 0);
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        predict_position(mean + i * stride, mean + (i + 4) * stride, n, _dt);
+    }
+
+    const track_real_t* held = states.held_values.data();
+    for (int t : states.held) {
+        for (int k = 0; k < 8; k++) mean[k * stride + t] = *held++;
+        for (int k = 0; k < KAL_COVA_SIZE; k++) cov[k * stride + t] = *held++;
+    }
+}
+
+void KalmanFilter::project(const track_real_t* mean,
+                           const track_real_t* covariance,
+                           int          stride,
+                           track_real_t        projected_mean[4],
+                           track_real_t        projected_cov[4]) const {
+    track_real_t std[4];
+    std[0] = _std_weight_position * mean[3 * stride];
+    std[1] = _std_weight_position * mean[3 * stride];
+    std[2] = 1e-1;
+    std[3] = _std_weight_position * mean[3 * stride];
+
+    for (int i = 0; i < 4; i++) {
+        projected_mean[i] = mean[i * stride];
+        projected_cov[i]  = covariance[(KAL_PP + i) * stride] + variance(std[i]);
+    }
+}
+
+void KalmanFilter::update(track_real_t* mean, track_real_t* covariance, int stride, const track_real_t measurement[4]) const {
+    track_real_t projected_mean[4], projected_cov[4];
+    project(mean, covariance, stride, projected_mean, projected_cov);
+
+    // the projected covariance is diagonal, so its cholesky factor is the element wise square root and the gain
+    // solve is two scalings by its reciprocal (as the triangular solves do it); K = P H' S^-1 only has the
+    // (i, i) and (i + 4, i) entries
+    for (int i = 0; i < 4; i++) {
+        track_real_t pp = covariance[(KAL_PP + i) * stride];
+        track_real_t pv = covariance[(KAL_PV + i) * stride];
+        track_real_t vv = covariance[(KAL_VV + i) * stride];
+        track_real_t s  = projected_cov[i];
+    #if BYTE_TRACKER_FIXED_POINT
+        // r * r would drop most of the 16 fraction bits, divide once instead and use K S = P H'
+        track_real_t kp = pp / s;
+        track_real_t kv = pv / s;
+
+        track_real_t innovation = measurement[i] - projected_mean[i];
+        mean[i * stride] += innovation * kp;
+        mean[(i + 4) * stride] += innovation * kv;
+
+        covariance[(KAL_PP + i) * stride] = pp - kp * pp;
+        covariance[(KAL_PV + i) * stride] = pv - kp * pv;
+        covariance[(KAL_VV + i) * stride] = vv - kv * pv;
+    #else
+        track_real_t r  = 1 / std::sqrt(s);
+        track_real_t kp = pp * r * r;
+        track_real_t kv = pv * r * r;
+
+        track_real_t innovation = measurement[i] - projected_mean[i];
+        mean[i * stride] += innovation * kp;
+        mean[(i + 4) * stride] += innovation * kv;
+
+        // P - K S K'
+        covariance[(KAL_PP + i) * stride] = pp - kp * s * kp;
+        covariance[(KAL_PV + i) * stride] = pv - kp * s * kv;
+        covariance[(KAL_VV + i) * stride] = vv - kv * s * kv;
+    #endif
+    }
+}
+
+}  // namespace byte_kalman
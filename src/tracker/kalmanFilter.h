@@ -0,0 +1,81 @@
+/*
+ * MIT License
+ * Copyright (c) 2021 Yifu Zhang
+ *
+ * Modified by nullptr, Apr 15, 2024, Seeed Technology Co.,Ltd
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "dataType.h"
+
+namespace byte_kalman {
+
+// Mean and packed covariance of many tracks as structure of arrays: element k of track t is at
+// mean(t)[k * stride()] and covariance(t)[k * stride()], so a loop over the tracks walks contiguous memory.
+// Growing past the capacity relays the planes, pointers are only good until the next resize().
+class KalmanStates {
+   public:
+    KalmanStates();
+
+    int size() const { return n; }
+    int stride() const { return capacity; }
+    // keeps the tracks below n
+    void resize(int n);
+    // grows the capacity to at least n without changing the size
+    void reserve(int n);
+
+    track_real_t*       mean(int t) { return &means[t]; }
+    const track_real_t* mean(int t) const { return &means[t]; }
+    track_real_t*       covariance(int t) { return &covariances[t]; }
+    const track_real_t* covariance(int t) const { return &covariances[t]; }
+
+    // per track, for multi_predict(): 0 leaves it alone, KAL_PREDICT predicts it, KAL_PREDICT_TRACKED also
+    // marks it as in the Tracked state
+    std::vector<uint8_t> mask;
+
+   private:
+    friend class KalmanFilter;
+
+    int                       n;
+    int                       capacity;
+    std::vector<int>          held;  // multi_predict() scratch
+    std::vector<track_real_t> held_values;
+    std::vector<track_real_t> means;
+    std::vector<track_real_t> covariances;
+};
+
+// Constant velocity filter over (x, y, a, h) and their velocities. The motion matrix is identity plus a dt block
+// and the measurement selects the first four states, and the initial and noise covariances are diagonal, so every
+// coordinate only ever correlates with its own velocity: the 8x8 covariance is four symmetric 2x2 blocks. It is
+// kept packed as KAL_COVA_SIZE values, the position variances, then the position/velocity covariances, then the
+// velocity variances, one per coordinate each.
+//
+// All methods address a track's elements as mean[k * stride], see KalmanStates.
+class KalmanFilter {
+   public:
+    static const double chi2inv95[10];
+
+    KalmanFilter();
+
+    void initiate(const track_real_t measurement[4], track_real_t* mean, track_real_t* covariance, int stride) const;
+    // predicts every track flagged in states.mask, one pass over all tracks per state element
+    void multi_predict(KalmanStates& states) const;
+    // measurement space mean and (diagonal) covariance
+    void project(const track_real_t* mean,
+                 const track_real_t* covariance,
+                 int                 stride,
+                 track_real_t        projected_mean[4],
+                 track_real_t        projected_cov[4]) const;
+    void update(track_real_t* mean, track_real_t* covariance, int stride, const track_real_t measurement[4]) const;
+
+   private:
+    track_real_t _dt;
+    track_real_t _std_weight_position;
+    track_real_t _std_weight_velocity;
+};
+
+}  // namespace byte_kalman
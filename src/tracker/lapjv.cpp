@@ -0,0 +1,98 @@
+#include "lapjv.h"
+
+#include <algorithm>
+#include <limits>
+
+void LapJV::reserve(int rows, int cols) {
+    u.reserve(rows);
+    sr.reserve(rows);
+    v.reserve(cols);
+    shortest.reserve(cols);
+    path.reserve(cols);
+    remaining.reserve(cols);
+    sc.reserve(cols);
+}
+
+int LapJV::solve(const track_real_t* cost, int rows, int cols, int* x, int* y) {
+    const track_real_t inf = std::numeric_limits<track_real_t>::infinity();
+
+    u.assign(rows, 0);
+    sr.resize(rows);
+    v.assign(cols, 0);
+    shortest.resize(cols);
+    path.resize(cols);
+    remaining.resize(cols);
+    sc.resize(cols);
+
+    for (int i = 0; i < rows; i++) x[i] = -1;
+    for (int j = 0; j < cols; j++) y[j] = -1;
+
+    for (int cur_row = 0; cur_row < rows; cur_row++) {
+        // dijkstra over the columns from cur_row, on costs reduced by the potentials u and v
+        int n_remaining = cols;
+        for (int it = 0; it < cols; it++) {
+            remaining[it] = cols - it - 1;
+            shortest[it]  = inf;
+        }
+        std::fill(sr.begin(), sr.end(), 0);
+        std::fill(sc.begin(), sc.end(), 0);
+
+        track_real_t min_val = 0;
+        int          i       = cur_row;
+        int          sink    = -1;
+        while (sink == -1) {
+            sr[i]                  = 1;
+            const track_real_t* ci = cost + i * cols;
+            track_real_t        lowest = inf;
+            int                 index  = -1;
+            for (int it = 0; it < n_remaining; it++) {
+                int          j = remaining[it];
+                track_real_t r = min_val + ci[j] - u[i] - v[j];
+                if (r < shortest[j]) {
+                    path[j]     = i;
+                    shortest[j] = r;
+                }
+                // prefer a free column on ties, it ends the search
+                if (shortest[j] < lowest || (shortest[j] == lowest && y[j] == -1)) {
+                    lowest = shortest[j];
+                    index  = it;
+                }
+            }
+            if (index == -1) {
+                return -1;
+            }
+
+            min_val = lowest;
+            int j   = remaining[index];
+            if (y[j] == -1) {
+                sink = j;
+            } else {
+                i = y[j];
+            }
+            sc[j]            = 1;
+            remaining[index] = remaining[--n_remaining];
+        }
+
+        // update the potentials
+        u[cur_row] += min_val;
+        for (int r = 0; r < rows; r++) {
+            if (sr[r] && r != cur_row) u[r] += min_val - shortest[x[r]];
+        }
+        for (int c = 0; c < cols; c++) {
+            if (sc[c]) v[c] -= min_val - shortest[c];
+        }
+
+        // augment along the path back to cur_row
+        int j = sink;
+        while (true) {
+            int r = path[j];
+            y[j]  = r;
+            int t = x[r];
+            x[r]  = j;
+            j     = t;
+            if (r == cur_row) break;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,30 @@
+#ifndef LAPJV_H
+#define LAPJV_H
+
+#include <cstdint>
+#include <vector>
+
+#include "dataType.h"
+
+// Rectangular linear assignment by shortest augmenting paths (Jonker-Volgenant, as laid out by Crouse 2016).
+// The cost matrix is row major, rows <= cols, and every row gets a column. The scratch arrays are kept
+// between calls, so once the workspace has grown to the largest problem seen, solving does not allocate.
+class LapJV {
+   public:
+    // grows the workspace up front, so solve() never allocates for problems up to rows x cols
+    void reserve(int rows, int cols);
+
+    // x[row] = col, y[col] = row or -1; returns 0, or -1 if the costs are not finite
+    int solve(const track_real_t* cost, int rows, int cols, int* x, int* y);
+
+   private:
+    std::vector<track_real_t> u;
+    std::vector<track_real_t> v;
+    std::vector<track_real_t> shortest;
+    std::vector<int>          path;
+    std::vector<int>          remaining;
+    std::vector<uint8_t>      sr;
+    std::vector<uint8_t>      sc;
+};
+
+#endif  // LAPJV_H
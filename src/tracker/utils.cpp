@@ -0,0 +1,452 @@
+/*
+ * MIT License
+ * Copyright (c) 2021 Yifu Zhang
+ *
+ * Modified by nullptr, Apr 15, 2024, Seeed Technology Co.,Ltd
+*/
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdbool>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include "BYTETracker.h"
+#include "lapjv.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+#endif
+
+using namespace std;
+
+void BYTETracker::to_pointers(vector<STrack*>& res, vector<STrack>& stracks, const vector<int>& indices) {
+    res.clear();
+    for (int i : indices) {
+        res.push_back(&stracks[i]);
+    }
+}
+
+void BYTETracker::to_pointers(vector<STrack*>& res, vector<STrack>& stracks) {
+    res.clear();
+    for (STrack& strack : stracks) {
+        res.push_back(&strack);
+    }
+}
+
+int BYTETracker::alloc_track(const STrack& track) {
+    if (!pool_free.empty()) {
+        int idx = pool_free.back();
+        pool_free.pop_back();
+        pool[idx]         = track;
+        pool[idx].slot    = idx;
+        pool_removed[idx] = 0;
+        return idx;
+    }
+    if (pool.size() >= BYTE_TRACKER_MAX_TRACKS) {
+        return -1;
+    }
+    pool.push_back(track);
+    pool.back().slot = pool.size() - 1;
+    pool_removed.push_back(0);
+    kalman_states.resize(pool.size());
+    return pool.size() - 1;
+}
+
+// appends the tracks of tlistb not yet in tlista, keeping the order of both
+void BYTETracker::joint_stracks(vector<int>& tlista, const vector<int>& tlistb) {
+    in_list.assign(pool.size(), 0);
+    for (int i : tlista) {
+        in_list[i] = 1;
+    }
+    for (int i : tlistb) {
+        if (!in_list[i]) {
+            in_list[i] = 1;
+            tlista.push_back(i);
+        }
+    }
+}
+
+// drops the tracks of tlistb from tlista, the rest ends up ordered by track id
+void BYTETracker::sub_stracks(vector<int>& tlista, const vector<int>& tlistb) {
+    in_list.assign(pool.size(), 0);
+    for (int i : tlistb) {
+        in_list[i] = 1;
+    }
+    size_t kept = 0;
+    for (int i : tlista) {
+        if (!in_list[i]) {
+            tlista[kept++] = i;
+        }
+    }
+    tlista.resize(kept);
+    sort_stracks(tlista);
+}
+
+void BYTETracker::sort_stracks(vector<int>& tlist) {
+    sort(tlist.begin(), tlist.end(), [this](int a, int b) { return pool[a].track_id < pool[b].track_id; });
+}
+
+void BYTETracker::remove_duplicate_stracks(vector<int>& stracksa, vector<int>& stracksb) {
+    int dist_size = 0, dist_size_size = 0;
+    to_pointers(atracks, pool, stracksa);
+    to_pointers(btracks, pool, stracksb);
+    iou_distance(atracks, btracks, dist_size, dist_size_size);
+
+    dup_a.assign(stracksa.size(), 0);
+    dup_b.assign(stracksb.size(), 0);
+    for (int i = 0; i < dist_size; i++) {
+        for (int j = 0; j < dist_size_size; j++) {
+            if (dists[i * dist_size_size + j] < 0.15) {
+                int timep = pool[stracksa[i]].frame_id - pool[stracksa[i]].start_frame;
+                int timeq = pool[stracksb[j]].frame_id - pool[stracksb[j]].start_frame;
+                if (timep > timeq)
+                    dup_b[j] = 1;
+                else
+                    dup_a[i] = 1;
+            }
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < stracksa.size(); i++) {
+        if (!dup_a[i]) {
+            stracksa[kept++] = stracksa[i];
+        }
+    }
+    stracksa.resize(kept);
+
+    kept = 0;
+    for (size_t i = 0; i < stracksb.size(); i++) {
+        if (!dup_b[i]) {
+            stracksb[kept++] = stracksb[i];
+        }
+    }
+    stracksb.resize(kept);
+}
+
+static int find_root(vector<int>& parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i         = parent[i];
+    }
+    return i;
+}
+
+// fills rowsol / colsol. Only pairs cheaper than thresh can ever be matched, so rows and columns (nodes rows + j)
+// are split into the connected components of that graph and each is solved on its own: lone nodes stay
+// unmatched, a component with a single row or column takes its cheapest pair, and only what is left goes to JV
+int BYTETracker::assign(const track_real_t* cost, int rows, int cols, track_real_t thresh) {
+    int ret = 0;
+
+    rowsol.assign(rows, -1);
+    colsol.assign(cols, -1);
+
+    lap_parent.resize(rows + cols);
+    for (int i = 0; i < rows + cols; i++) lap_parent[i] = i;
+
+    int edges = 0;
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            if (cost[i * cols + j] < thresh) {
+                int a = find_root(lap_parent, i);
+                int b = find_root(lap_parent, rows + j);
+                if (a != b) lap_parent[max(a, b)] = min(a, b);
+                edges++;
+            }
+        }
+    }
+    if (edges == 0) {
+        return ret;
+    }
+
+    // group the nodes by component, rows before columns and in index order inside each
+    lap_nodes.resize(rows + cols);
+    for (int i = 0; i < rows + cols; i++) lap_nodes[i] = i;
+    for (int i = 0; i < rows + cols; i++) lap_parent[i] = find_root(lap_parent, i);
+    sort(lap_nodes.begin(), lap_nodes.end(), [this](int a, int b) {
+        return lap_parent[a] != lap_parent[b] ? lap_parent[a] < lap_parent[b] : a < b;
+    });
+
+    for (int begin = 0; begin < rows + cols;) {
+        int end = begin;
+        while (end < rows + cols && lap_parent[lap_nodes[end]] == lap_parent[lap_nodes[begin]]) end++;
+        int n_rows = 0;
+        while (begin + n_rows < end && lap_nodes[begin + n_rows] < rows) n_rows++;
+        int        n_cols    = end - begin - n_rows;
+        const int* comp_rows = &lap_nodes[begin];
+        const int* comp_cols = &lap_nodes[begin + n_rows];
+        begin                = end;
+
+        if (n_rows == 0 || n_cols == 0) {
+            continue;
+        }
+        if (n_rows == 1 || n_cols == 1) {
+            // a star, every gated pair shares the centre, so the cheapest one is the whole answer
+            int best_i = comp_rows[0], best_j = comp_cols[0] - rows;
+            for (int a = 0; a < n_rows; a++) {
+                for (int b = 0; b < n_cols; b++) {
+                    int i = comp_rows[a], j = comp_cols[b] - rows;
+                    if (cost[i * cols + j] < cost[best_i * cols + best_j]) {
+                        best_i = i;
+                        best_j = j;
+                    }
+                }
+            }
+            rowsol[best_i] = best_j;
+            colsol[best_j] = best_i;
+            continue;
+        }
+
+        lap_sub.resize(n_rows * n_cols);
+        for (int a = 0; a < n_rows; a++) {
+            for (int b = 0; b < n_cols; b++) {
+                lap_sub[a * n_cols + b] = cost[comp_rows[a] * cols + comp_cols[b] - rows];
+            }
+        }
+        if (lapjv(lap_sub.data(), n_rows, n_cols, thresh, sub_rowsol, sub_colsol) != 0) {
+            ret = -1;
+            continue;
+        }
+        for (int a = 0; a < n_rows; a++) {
+            if (sub_rowsol[a] < 0) continue;
+            int i     = comp_rows[a];
+            int j     = comp_cols[sub_rowsol[a]] - rows;
+            rowsol[i] = j;
+            colsol[j] = i;
+        }
+    }
+    return ret;
+}
+
+int BYTETracker::linear_assignment(const track_real_t*      cost_matrix,
+                                   int                      cost_matrix_size,
+                                   int                      cost_matrix_size_size,
+                                   track_real_t             thresh,
+                                   vector<pair<int, int> >& matches,
+                                   vector<int>&             unmatched_a,
+                                   vector<int>&             unmatched_b) {
+    if (cost_matrix_size * cost_matrix_size_size == 0) {
+        for (int i = 0; i < cost_matrix_size; i++) {
+            unmatched_a.push_back(i);
+        }
+        for (int i = 0; i < cost_matrix_size_size; i++) {
+            unmatched_b.push_back(i);
+        }
+        return 0;
+    }
+
+    int ret = assign(cost_matrix, cost_matrix_size, cost_matrix_size_size, thresh);
+
+    int rowsol_size = static_cast<int>(rowsol.size());
+    for (int i = 0; i < rowsol_size; i++) {
+        if (rowsol[i] >= 0) {
+            matches.emplace_back(i, rowsol[i]);
+        } else {
+            unmatched_a.push_back(i);
+        }
+    }
+
+    int colsol_size = static_cast<int>(colsol.size());
+    for (int i = 0; i < colsol_size; i++) {
+        if (colsol[i] < 0) {
+            unmatched_b.push_back(i);
+        }
+    }
+    return ret;
+}
+
+#if BYTE_TRACKER_FIXED_POINT
+// 1 - iou of every a/b pair, boxes given as x1, y1, x2, y2 planes of na and nb values each
+// a 640x480 box has an area far outside Q16.16, so areas and intersections are kept as Q32.32 in 64 bits
+static void iou_distance_kernel(const q16_t* a, int na, const q16_t* b, int nb, q16_t* out) {
+    const q16_t* ax1 = a;
+    const q16_t* ay1 = a + na;
+    const q16_t* ax2 = a + na * 2;
+    const q16_t* ay2 = a + na * 3;
+    const q16_t* bx1 = b;
+    const q16_t* by1 = b + nb;
+    const q16_t* bx2 = b + nb * 2;
+    const q16_t* by2 = b + nb * 3;
+    const int64_t one = q16_t::ONE;
+
+    for (int n = 0; n < na; n++) {
+        q16_t*  row    = out + n * nb;
+        int64_t area_a = (ax2[n].raw - ax1[n].raw + one) * (ay2[n].raw - ay1[n].raw + one);
+        for (int k = 0; k < nb; k++) {
+            int64_t area_b = (bx2[k].raw - bx1[k].raw + one) * (by2[k].raw - by1[k].raw + one);
+            int64_t iw     = min(ax2[n].raw, bx2[k].raw) - max(ax1[n].raw, bx1[k].raw) + one;
+            int64_t ih     = min(ay2[n].raw, by2[k].raw) - max(ay1[n].raw, by1[k].raw) + one;
+            int64_t iou    = 0;
+            if (iw > 0 && ih > 0) {
+                int64_t inter = iw * ih;
+                int64_t ua    = (area_a + area_b - inter) >> q16_t::FRAC_BITS;
+                iou           = ua > 0 ? min(inter / ua, one) : one;
+            }
+            row[k] = q16_t::from_raw(static_cast<int32_t>(one - iou));
+        }
+    }
+}
+#else
+// 1 - iou of every a/b pair, boxes given as x1, y1, x2, y2 planes of na and nb floats each
+// the vector paths do the same operations in the same order as the scalar one, so results match bit for bit
+static void iou_distance_kernel(const float* a, int na, const float* b, int nb, float* out) {
+    const float* ax1 = a;
+    const float* ay1 = a + na;
+    const float* ax2 = a + na * 2;
+    const float* ay2 = a + na * 3;
+    const float* bx1 = b;
+    const float* by1 = b + nb;
+    const float* bx2 = b + nb * 2;
+    const float* by2 = b + nb * 3;
+
+    for (int n = 0; n < na; n++) {
+        float* row    = out + n * nb;
+        float  area_a = (ax2[n] - ax1[n] + 1) * (ay2[n] - ay1[n] + 1);
+        int    k      = 0;
+
+#if defined(__SSE2__)
+        const __m128 one  = _mm_set1_ps(1.f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 vax1 = _mm_set1_ps(ax1[n]), vay1 = _mm_set1_ps(ay1[n]);
+        const __m128 vax2 = _mm_set1_ps(ax2[n]), vay2 = _mm_set1_ps(ay2[n]);
+        const __m128 varea = _mm_set1_ps(area_a);
+        for (; k + 4 <= nb; k += 4) {
+            __m128 vbx1 = _mm_loadu_ps(bx1 + k), vby1 = _mm_loadu_ps(by1 + k);
+            __m128 vbx2 = _mm_loadu_ps(bx2 + k), vby2 = _mm_loadu_ps(by2 + k);
+            __m128 area_b = _mm_mul_ps(_mm_add_ps(_mm_sub_ps(vbx2, vbx1), one), _mm_add_ps(_mm_sub_ps(vby2, vby1), one));
+            __m128 iw     = _mm_add_ps(_mm_sub_ps(_mm_min_ps(vax2, vbx2), _mm_max_ps(vax1, vbx1)), one);
+            __m128 ih     = _mm_add_ps(_mm_sub_ps(_mm_min_ps(vay2, vby2), _mm_max_ps(vay1, vby1)), one);
+            __m128 inter  = _mm_mul_ps(iw, ih);
+            __m128 ua     = _mm_sub_ps(_mm_add_ps(varea, area_b), inter);
+            __m128 mask   = _mm_and_ps(_mm_cmpgt_ps(iw, zero), _mm_cmpgt_ps(ih, zero));
+            __m128 iou    = _mm_and_ps(mask, _mm_div_ps(inter, ua));
+            _mm_storeu_ps(row + k, _mm_sub_ps(one, iou));
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        const float32x4_t one   = vdupq_n_f32(1.f);
+        const float32x4_t zero  = vdupq_n_f32(0.f);
+        const float32x4_t vax1  = vdupq_n_f32(ax1[n]), vay1 = vdupq_n_f32(ay1[n]);
+        const float32x4_t vax2  = vdupq_n_f32(ax2[n]), vay2 = vdupq_n_f32(ay2[n]);
+        const float32x4_t varea = vdupq_n_f32(area_a);
+        for (; k + 4 <= nb; k += 4) {
+            float32x4_t vbx1 = vld1q_f32(bx1 + k), vby1 = vld1q_f32(by1 + k);
+            float32x4_t vbx2 = vld1q_f32(bx2 + k), vby2 = vld1q_f32(by2 + k);
+            float32x4_t area_b =
+              vmulq_f32(vaddq_f32(vsubq_f32(vbx2, vbx1), one), vaddq_f32(vsubq_f32(vby2, vby1), one));
+            float32x4_t iw    = vaddq_f32(vsubq_f32(vminq_f32(vax2, vbx2), vmaxq_f32(vax1, vbx1)), one);
+            float32x4_t ih    = vaddq_f32(vsubq_f32(vminq_f32(vay2, vby2), vmaxq_f32(vay1, vby1)), one);
+            float32x4_t inter = vmulq_f32(iw, ih);
+            float32x4_t ua    = vsubq_f32(vaddq_f32(varea, area_b), inter);
+            uint32x4_t  mask  = vandq_u32(vcgtq_f32(iw, zero), vcgtq_f32(ih, zero));
+            float32x4_t iou   = vreinterpretq_f32_u32(vandq_u32(mask, vreinterpretq_u32_f32(vdivq_f32(inter, ua))));
+            vst1q_f32(row + k, vsubq_f32(one, iou));
+        }
+#endif
+        // scalar tail, and the whole row where there is no float simd (the ESP32-S3 PIE is integer only)
+        for (; k < nb; k++) {
+            float area_b = (bx2[k] - bx1[k] + 1) * (by2[k] - by1[k] + 1);
+            float iw     = min(ax2[n], bx2[k]) - max(ax1[n], bx1[k]) + 1;
+            float ih     = min(ay2[n], by2[k]) - max(ay1[n], by1[k]) + 1;
+            float iou    = 0.f;
+            if (iw > 0 && ih > 0) {
+                float inter = iw * ih;
+                iou         = inter / (area_a + area_b - inter);
+            }
+            row[k] = 1 - iou;
+        }
+    }
+}
+#endif
+
+static void to_planes(vector<track_real_t>& planes, const vector<STrack*>& tracks) {
+    int n = tracks.size();
+    planes.resize(n * 4);
+    for (int i = 0; i < n; i++) {
+        planes[i]         = tracks[i]->tlbr[0];
+        planes[n + i]     = tracks[i]->tlbr[1];
+        planes[n * 2 + i] = tracks[i]->tlbr[2];
+        planes[n * 3 + i] = tracks[i]->tlbr[3];
+    }
+}
+
+void BYTETracker::iou_distance(const vector<STrack*>& atracks,
+                               const vector<STrack*>& btracks,
+                               int&                   dist_size,
+                               int&                   dist_size_size) {
+    dist_size      = atracks.size();
+    dist_size_size = btracks.size();
+    if (dist_size * dist_size_size == 0) {
+        dists.clear();
+        return;
+    }
+
+    to_planes(boxes_a, atracks);
+    to_planes(boxes_b, btracks);
+    dists.resize(dist_size * dist_size_size);
+    iou_distance_kernel(boxes_a.data(), dist_size, boxes_b.data(), dist_size_size, dists.data());
+
+#if BYTE_TRACKER_CLASS_AWARE
+    // a pair across labels costs as much as no overlap, which no gate admits, so assign() splits the
+    // problem into one per label
+    labels_b.resize(dist_size_size);
+    for (int j = 0; j < dist_size_size; j++) {
+        labels_b[j] = btracks[j]->label;
+    }
+    for (int i = 0; i < dist_size; i++) {
+        const int     label = atracks[i]->label;
+        const int*    lb    = labels_b.data();
+        track_real_t* row   = dists.data() + i * dist_size_size;
+        for (int j = 0; j < dist_size_size; j++) {
+            row[j] = lb[j] == label ? row[j] : track_real_t(1);
+        }
+    }
+#endif
+}
+
+int BYTETracker::lapjv(const track_real_t* cost,
+                       int                 n_rows,
+                       int                 n_cols,
+                       track_real_t        cost_limit,
+                       vector<int>&        rowsol,
+                       vector<int>&        colsol) {
+    rowsol.resize(n_rows);
+    colsol.resize(n_cols);
+
+    // leaving a row or column unmatched costs cost_limit / 2, so a pair is only worth taking while its cost is
+    // below cost_limit; clamping c - cost_limit at 0 turns that into a plain rectangular assignment where every
+    // row of the smaller side is matched, and the zero cost pairs are dropped afterwards
+    bool transpose = n_rows > n_cols;
+    int  rows      = transpose ? n_cols : n_rows;
+    int  cols      = transpose ? n_rows : n_cols;
+    lap_cost.resize(rows * cols);
+    for (int i = 0; i < n_rows; i++) {
+        for (int j = 0; j < n_cols; j++) {
+            track_real_t c = cost[i * n_cols + j] - cost_limit;
+
+            lap_cost[transpose ? j * n_rows + i : i * n_cols + j] = c < 0 ? c : track_real_t(0);
+        }
+    }
+
+    int* x = transpose ? colsol.data() : rowsol.data();
+    int* y = transpose ? rowsol.data() : colsol.data();
+    if (lap.solve(lap_cost.data(), rows, cols, x, y) != 0) {
+        fill(rowsol.begin(), rowsol.end(), -1);
+        fill(colsol.begin(), colsol.end(), -1);
+        return -1;
+    }
+
+    for (int i = 0; i < n_rows; i++) {
+        int j = rowsol[i];
+        if (j >= 0 && !(cost[i * n_cols + j] < cost_limit)) {
+            rowsol[i] = -1;
+            colsol[j] = -1;
+        }
+    }
+
+    return 0;
+}